@@ -1,145 +1,175 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "driver/gpio.h"
-#include "driver/ledc.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "ir_sensor.h"
+#include "buzzer.h"
+#include "latency_hist.h"
+#include "app_tasks.h"
 
-#define IR_SENSOR_PIN GPIO_NUM_5
-#define BUZZER_PIN GPIO_NUM_2
+#define MAX_DETECTIONS          10
+#define CONTINUOUS_BEEP_FREQ    2000
+#define CONTINUOUS_BEEP_DURATION 5000
 
-#define LEDC_TIMER              LEDC_TIMER_0
-#define LEDC_MODE               LEDC_LOW_SPEED_MODE
-#define LEDC_CHANNEL            LEDC_CHANNEL_0
-#define LEDC_DUTY_RES           LEDC_TIMER_13_BIT
+#define IR_EVENT_QUEUE_LEN      8
+#define IR_DEBOUNCE_US          50000
 
-#define MAX_DETECTIONS          10
-#define CONTINUOUS_BEEP_FREQ    2000   
-#define CONTINUOUS_BEEP_DURATION 5000  
+#define DETECTION_STACK_SIZE    2048
 
 static const char *TAG = "OBSTACLE_DETECTION";
 
 static int detection_count = 0;
 static bool continuous_mode = false;
 
-void play_beep(uint32_t frequency, uint32_t duration_ms)
+// Edge timestamps from the IR ISR
+static QueueHandle_t ir_event_queue;
+#if CONFIG_APP_STATIC_ALLOC
+static StaticQueue_t ir_event_queue_buf;
+static uint8_t ir_event_queue_storage[IR_EVENT_QUEUE_LEN * sizeof(int64_t)];
+#endif
+
+// Latency from IR edge to the detection task picking it up, and from there to the buzzer sounding
+static latency_hist_t dequeue_hist = LATENCY_HIST_INIT;
+static latency_hist_t actuate_hist = LATENCY_HIST_INIT;
+
+// Switch the buzzer on and record the time since the detection task took
+// the edge. Returns the tick the tone started on, for vTaskDelayUntil().
+// Anything slow, like logging, goes after this.
+static TickType_t alert_start(uint32_t frequency, int64_t dequeue_us)
 {
-    ledc_set_freq(LEDC_MODE, LEDC_TIMER, frequency);
-    
-    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 4096);
-    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
-    
-    vTaskDelay(pdMS_TO_TICKS(duration_ms));
-
-    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0);
-    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+    buzzer_start(frequency);
+    latency_hist_record(&actuate_hist, esp_timer_get_time() - dequeue_us);
+    return xTaskGetTickCount();
 }
 
-void start_continuous_beep(uint32_t frequency)
+void play_obstacle_alert(int64_t dequeue_us)
 {
-    ledc_set_freq(LEDC_MODE, LEDC_TIMER, frequency);
-    
-    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 4096);
-    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+    TickType_t wake = alert_start(1000, dequeue_us);
+    ESP_LOGI(TAG, "Obstacle detected! Count: %d/%d", detection_count, MAX_DETECTIONS);
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(200));
+    buzzer_stop();
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    for (int i = 1; i < 3; i++) {
+        buzzer_beep(1000, 200);
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
 }
 
-void stop_continuous_beep(void)
+static void log_latency_hist(const char *stage, const latency_hist_t *hist)
 {
-    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0);
-    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+    latency_hist_t snapshot;
+    latency_hist_snapshot(hist, &snapshot);
+
+    ESP_LOGI(TAG, "%s: %lu samples, max %lu us", stage,
+             (unsigned long)snapshot.count, (unsigned long)snapshot.max_us);
+    for (int i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+        if (snapshot.buckets[i] > 0) {
+            ESP_LOGI(TAG, "  >= %lu us: %lu", i == 0 ? 0UL : 1UL << (i - 1), (unsigned long)snapshot.buckets[i]);
+        }
+    }
 }
 
-void play_obstacle_alert(void)
+void log_latency_stats(void)
 {
-    for (int i = 0; i < 3; i++) {
-        play_beep(1000, 200); 
-        vTaskDelay(pdMS_TO_TICKS(100));
-    }
+    log_latency_hist("IR edge -> dequeue", &dequeue_hist);
+    log_latency_hist("dequeue -> buzzer", &actuate_hist);
 }
 
-void play_continuous_alert(void)
+void play_continuous_alert(int64_t dequeue_us)
 {
+    TickType_t wake = alert_start(CONTINUOUS_BEEP_FREQ, dequeue_us);
+    ESP_LOGI(TAG, "Obstacle detected! Count: %d/%d", detection_count, MAX_DETECTIONS);
+    ESP_LOGI(TAG, "Maximum detections reached! Switching to continuous mode.");
     ESP_LOGI(TAG, "Playing continuous beep for %d seconds...", CONTINUOUS_BEEP_DURATION/1000);
-    
-    start_continuous_beep(CONTINUOUS_BEEP_FREQ);
-    vTaskDelay(pdMS_TO_TICKS(CONTINUOUS_BEEP_DURATION));
-    stop_continuous_beep();
-    
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(CONTINUOUS_BEEP_DURATION));
+    buzzer_stop();
+
     ESP_LOGI(TAG, "Continuous beep finished. Resetting detection count.");
+    log_latency_stats();
     detection_count = 0;
     continuous_mode = false;
 }
 
-void buzzer_init(void)
+static void IRAM_ATTR ir_sensor_isr(void *arg)
 {
-    ledc_timer_config_t ledc_timer = {
-        .speed_mode       = LEDC_MODE,
-        .timer_num        = LEDC_TIMER,
-        .duty_resolution  = LEDC_DUTY_RES,
-        .freq_hz          = 1000,
-        .clk_cfg          = LEDC_AUTO_CLK
-    };
-    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-    ledc_channel_config_t ledc_channel = {
-        .speed_mode     = LEDC_MODE,
-        .channel        = LEDC_CHANNEL,
-        .timer_sel      = LEDC_TIMER,
-        .intr_type      = LEDC_INTR_DISABLE,
-        .gpio_num       = BUZZER_PIN,
-        .duty           = 0,
-        .hpoint         = 0
-    };
-    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+    int64_t edge_us = esp_timer_get_time();
+    BaseType_t higher_priority_woken = pdFALSE;
+
+    xQueueSendFromISR(ir_event_queue, &edge_us, &higher_priority_woken);
+    if (higher_priority_woken) {
+        portYIELD_FROM_ISR();
+    }
 }
 
-void ir_sensor_init(void)
+void ir_events_init(void)
 {
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE;
-    io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pin_bit_mask = (1ULL << IR_SENSOR_PIN);
-    io_conf.pull_down_en = 0;
-    io_conf.pull_up_en = 1;
-    gpio_config(&io_conf);
+#if CONFIG_APP_STATIC_ALLOC
+    ir_event_queue = xQueueCreateStatic(IR_EVENT_QUEUE_LEN, sizeof(int64_t),
+                                        ir_event_queue_storage, &ir_event_queue_buf);
+#else
+    ir_event_queue = xQueueCreate(IR_EVENT_QUEUE_LEN, sizeof(int64_t));
+#endif
+
+    // Sensor output goes low when an obstacle appears
+    ESP_ERROR_CHECK(ir_sensor_init(GPIO_INTR_NEGEDGE));
+    ESP_ERROR_CHECK(ir_sensor_add_isr(ir_sensor_isr, NULL));
 }
 
 void obstacle_detection_task(void *pvParameters)
 {
-    bool previous_state = false;
-    
+    int64_t last_detection_us = -IR_DEBOUNCE_US;
+
     while (1) {
-        int sensor_state = gpio_get_level(IR_SENSOR_PIN);
-        bool obstacle_detected = (sensor_state == 0);
-        
-        if (obstacle_detected && !previous_state && !continuous_mode) {
-            detection_count++;
-            ESP_LOGI(TAG, "Obstacle detected! Count: %d/%d", detection_count, MAX_DETECTIONS);
-            
-            if (detection_count >= MAX_DETECTIONS) {
-                continuous_mode = true;
-                ESP_LOGI(TAG, "Maximum detections reached! Switching to continuous mode.");
-                play_continuous_alert();
-            } else {
-                play_obstacle_alert();
-            }
+        int64_t edge_us;
+        xQueueReceive(ir_event_queue, &edge_us, portMAX_DELAY);
+        int64_t dequeue_us = esp_timer_get_time();
+
+        // Ignore bounces and edges that did not leave the obstacle in view
+        if (edge_us - last_detection_us < IR_DEBOUNCE_US || !ir_sensor_object_detected()) {
+            continue;
         }
-        
-        previous_state = obstacle_detected;
-        vTaskDelay(pdMS_TO_TICKS(50));
+        last_detection_us = edge_us;
+        latency_hist_record(&dequeue_hist, dequeue_us - edge_us);
+
+        // Both alerts switch the buzzer on and record actuate_hist before logging
+        detection_count++;
+        if (detection_count >= MAX_DETECTIONS) {
+            continuous_mode = true;
+            play_continuous_alert(dequeue_us);
+        } else {
+            play_obstacle_alert(dequeue_us);
+        }
+
+        // Edges seen while the alert was playing are not new detections
+        xQueueReset(ir_event_queue);
     }
 }
 
+#if CONFIG_APP_STATIC_ALLOC
+static StackType_t detection_stack[DETECTION_STACK_SIZE];
+static StaticTask_t detection_tcb;
+#endif
+
+static app_task_t app_tasks[] = {
+    { obstacle_detection_task, "obstacle_detection", DETECTION_STACK_SIZE, 10, tskNO_AFFINITY,
+      APP_TASK_BUFFERS(detection_stack, detection_tcb) },
+};
+
 void app_main(void)
 {
     ESP_LOGI(TAG, "Starting Enhanced Obstacle Detection System");
-    ESP_LOGI(TAG, "Normal beep: 1kHz, Continuous beep after %d detections: %dHz", 
+    ESP_LOGI(TAG, "Normal beep: 1kHz, Continuous beep after %d detections: %dHz",
              MAX_DETECTIONS, CONTINUOUS_BEEP_FREQ);
-    
-    ir_sensor_init();
-    buzzer_init();
-    
-    xTaskCreate(obstacle_detection_task, "obstacle_detection", 2048, NULL, 10, NULL);
-    
+
+    ir_events_init();
+    ESP_ERROR_CHECK(buzzer_init());
+
+    app_tasks_start(app_tasks, APP_TASK_COUNT(app_tasks));
+    ESP_ERROR_CHECK(app_tasks_start_memory_report());
+    app_tasks_log_memory();
+
     ESP_LOGI(TAG, "System ready. Place object near IR sensor to test...");
 }
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Compare plain SensorData messages against SensorBatch on a synthetic sensor
+run: wire bytes per sample, encode and decode throughput, and the
+quantisation error batching adds.
+
+Usage:
+    python bench_telemetry.py [--samples 5000] [--scale 0.01 --scale 0.001]
+
+Uses sensor_pb2 when the protobuf package is installed, otherwise an
+equivalent hand-rolled encoding of the same messages, so byte counts are
+the same either way. The firmware's TELEMETRY_BENCH build prints the
+matching on-device numbers.
+"""
+
+import math
+import struct
+import sys
+import time
+
+import telemetry_codec
+
+try:
+    import sensor_pb2
+except ImportError:
+    sensor_pb2 = None
+
+BATCH_MAX_DATA = 224   # SensorBatch.data max_size in esp_server_protobuf/sensor.options
+CHANNELS = 2           # temperature, humidity
+
+def xorshift32(state):
+    state ^= (state << 13) & 0xFFFFFFFF
+    state ^= state >> 17
+    state ^= (state << 5) & 0xFFFFFFFF
+    return state
+
+def make_samples(n):
+    """Slowly drifting temperature and humidity with a little ADC-style noise"""
+    seed = 0x2545F491
+    samples = []
+    for i in range(n):
+        seed = xorshift32(seed)
+        noise = (seed % 1000) / 1000.0 - 0.5
+        samples.append((telemetry_codec.f32(21.5 + 2.0 * math.sin(i * 0.01) + 0.05 * noise),
+                        telemetry_codec.f32(48.0 + 5.0 * math.sin(i * 0.003) + 0.1 * noise)))
+    return samples
+
+# Fallback encoding, the same bytes protobuf produces for non-zero fields
+_float = struct.Struct('<f')
+
+def encode_sensor_data(temperature, humidity):
+    if sensor_pb2:
+        return sensor_pb2.SensorData(temperature=temperature, humidity=humidity).SerializeToString()
+    return b'\x0d' + _float.pack(temperature) + b'\x15' + _float.pack(humidity)
+
+def decode_sensor_data(data):
+    if sensor_pb2:
+        msg = sensor_pb2.SensorData.FromString(data)
+        return msg.temperature, msg.humidity
+    return _float.unpack_from(data, 1)[0], _float.unpack_from(data, 6)[0]
+
+def encode_sensor_batch(count, scale, data):
+    if sensor_pb2:
+        return sensor_pb2.SensorBatch(count=count, scale=scale, data=data).SerializeToString()
+    return (b'\x08' + telemetry_codec.encode_varint(count) + b'\x15' + _float.pack(scale) +
+            b'\x1a' + telemetry_codec.encode_varint(len(data)) + data)
+
+def decode_sensor_batch(msg):
+    if sensor_pb2:
+        batch = sensor_pb2.SensorBatch.FromString(msg)
+        return batch.count, batch.scale, batch.data
+    # Fields come in tag order from encode_sensor_batch
+    pos = 1
+    count = shift = 0
+    while True:
+        byte = msg[pos]
+        pos += 1
+        count |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    scale = _float.unpack_from(msg, pos + 1)[0]
+    pos += 6
+    length = shift = 0
+    while True:
+        byte = msg[pos]
+        pos += 1
+        length |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    return count, scale, msg[pos:pos + length]
+
+def timed(fn):
+    start = time.perf_counter()
+    result = fn()
+    return result, time.perf_counter() - start
+
+def bench_sensor_data(samples):
+    msgs, enc_s = timed(lambda: [encode_sensor_data(t, h) for t, h in samples])
+    decoded, dec_s = timed(lambda: [decode_sensor_data(m) for m in msgs])
+    return sum(len(m) for m in msgs), enc_s, dec_s, decoded
+
+def bench_sensor_batch(samples, scale):
+    def encode_all():
+        msgs = []
+        pos = 0
+        while pos < len(samples):
+            data, count = telemetry_codec.encode(samples[pos:], scale, BATCH_MAX_DATA)
+            msgs.append(encode_sensor_batch(count, scale, data))
+            pos += count
+        return msgs
+
+    def decode_all():
+        decoded = []
+        for m in msgs:
+            count, batch_scale, data = decode_sensor_batch(m)
+            batch = telemetry_codec.decode(data, CHANNELS, batch_scale)
+            if len(batch) != count:
+                raise ValueError(f"batch holds {len(batch)} samples, header says {count}")
+            decoded.extend(batch)
+        return decoded
+
+    msgs, enc_s = timed(encode_all)
+    decoded, dec_s = timed(decode_all)
+    return sum(len(m) for m in msgs), enc_s, dec_s, decoded
+
+def report(name, samples, nbytes, enc_s, dec_s, decoded):
+    max_err = max(abs(d - s) for ds, ss in zip(decoded, samples) for d, s in zip(ds, ss))
+    n = len(samples)
+    print(f"{name:<24} {nbytes / n:>8.2f} {n / enc_s:>12.0f} {n / dec_s:>12.0f} {max_err:>10.6f}")
+
+def main():
+    args = sys.argv[1:]
+    n = 5000
+    scales = []
+    while args:
+        opt = args.pop(0)
+        if opt == "--samples":
+            n = int(args.pop(0))
+        elif opt == "--scale":
+            scales.append(float(args.pop(0)))
+        else:
+            print(__doc__)
+            sys.exit(1)
+    scales = scales or [0.01, 0.001]
+
+    samples = make_samples(n)
+    print(f"{n} samples, {'protobuf' if sensor_pb2 else 'hand-rolled'} message encoding")
+    print(f"{'format':<24} {'B/sample':>8} {'enc samp/s':>12} {'dec samp/s':>12} {'max err':>10}")
+
+    report("SensorData", samples, *bench_sensor_data(samples))
+    for scale in scales:
+        report(f"SensorBatch scale={scale:g}", samples, *bench_sensor_batch(samples, scale))
+
+if __name__ == "__main__":
+    main()
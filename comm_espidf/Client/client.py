@@ -1,8 +1,42 @@
+import math
 import socket
+import struct
+import sys
 import sensor_pb2
+import telemetry_codec
 
 HOST = '10.16.1.17'  # IP of ESP32
 PORT = 3333           # Port ESP32 is listening on
+BATCH_SCALE = 0.01    # Resolution of batched samples
+BATCH_MAX_DATA = 224  # SensorBatch.data max_size in esp_server_protobuf/sensor.options
+ENVELOPE_SENSOR = 1   # Envelope oneof tags in esp_server_protobuf/envelope.proto
+ENVELOPE_BATCH = 7
+
+def frame(tag, payload):
+    # 2-byte big-endian length, then an Envelope carrying payload in oneof field tag
+    envelope = telemetry_codec.encode_varint(tag << 3 | 2) + telemetry_codec.encode_varint(len(payload)) + payload
+    return struct.pack('>H', len(envelope)) + envelope
+
+if len(sys.argv) > 1 and sys.argv[1] == 'batch':
+    # python client.py batch [samples]: stream a synthetic run to esp_server_protobuf
+    # as framed SensorBatch envelopes, all over one connection
+    n = int(sys.argv[2]) if len(sys.argv) > 2 else 1000
+    samples = [(27.5 + math.sin(i * 0.01), 65.2 + 2 * math.sin(i * 0.003)) for i in range(n)]
+
+    batches = 0
+    total = 0
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+        s.connect((HOST, PORT))
+        while samples:
+            packed, count = telemetry_codec.encode(samples, BATCH_SCALE, BATCH_MAX_DATA)
+            batch = sensor_pb2.SensorBatch(count=count, scale=BATCH_SCALE, data=packed)
+            framed = frame(ENVELOPE_BATCH, batch.SerializeToString())
+            s.sendall(framed)
+            samples = samples[count:]
+            batches += 1
+            total += len(framed)
+    print(f"Sent {n} samples in {batches} batches, {total / n:.2f} bytes/sample")
+    sys.exit(0)
 
 # Create and populate protobuf message
 data = sensor_pb2.SensorData()
@@ -12,8 +46,8 @@ data.humidity = 65.2
 # Serialize to bytes
 serialized_data = data.SerializeToString()
 
-# Send over TCP
+# Send over TCP as one framed envelope
 with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
     s.connect((HOST, PORT))
-    s.sendall(serialized_data)
-    print("Data sent to ESP32")
+    s.sendall(frame(ENVELOPE_SENSOR, serialized_data))
+print("Data sent to ESP32")
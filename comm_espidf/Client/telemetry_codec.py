@@ -0,0 +1,93 @@
+"""
+Delta + zigzag varint packing for SensorBatch.data, matching
+components/telemetry/telemetry_codec.c byte for byte.
+
+Each channel value is quantised to round(value / scale), coded as the
+difference from the same channel in the previous sample (the first sample
+against 0), zigzag mapped and written as a varint. Channels are
+interleaved. Arithmetic is done in float32 like the C side, so both
+produce the same bytes.
+"""
+
+import math
+import struct
+
+INT32_MIN = -(1 << 31)
+INT32_MAX = (1 << 31) - 1
+
+_f32 = struct.Struct('<f')
+
+def f32(x):
+    """Round a Python float to float32"""
+    return _f32.unpack(_f32.pack(x))[0]
+
+def zigzag(v):
+    return ((v << 1) ^ (v >> 31)) & 0xFFFFFFFF
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+def wrap32(v):
+    """Two's complement int32 wrap, as the C side's uint32 arithmetic"""
+    v &= 0xFFFFFFFF
+    return v - (1 << 32) if v & 0x80000000 else v
+
+def quantise(value, inv_scale):
+    p = f32(f32(value) * inv_scale)
+    if math.isnan(p):
+        return 0
+    if math.isinf(p):
+        return INT32_MAX if p > 0 else INT32_MIN
+    q = math.copysign(math.floor(abs(p) + 0.5), p)  # roundf: half away from zero
+    return int(min(max(q, INT32_MIN), INT32_MAX))
+
+def encode_varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return out
+
+def encode(samples, scale, max_len=None):
+    """Pack samples (sequences of channel values) and return (data, count).
+    With max_len, stops before the first sample that would not fit."""
+    inv_scale = f32(1.0 / f32(scale))
+    prev = None
+    data = bytearray()
+    count = 0
+    for sample in samples:
+        if prev is None:
+            prev = [0] * len(sample)
+        q = [quantise(v, inv_scale) for v in sample]
+        packed = b''.join(encode_varint(zigzag(wrap32(qc - pc))) for qc, pc in zip(q, prev))
+        if max_len is not None and len(data) + len(packed) > max_len:
+            break
+        data.extend(packed)
+        prev = q
+        count += 1
+    return bytes(data), count
+
+def decode(data, channels, scale):
+    """Unpack data into a list of channel-value tuples"""
+    scale = f32(scale)
+    prev = [0] * channels
+    samples = []
+    pos = 0
+    while pos < len(data):
+        sample = []
+        for c in range(channels):
+            value = shift = 0
+            while True:
+                if pos >= len(data) or shift > 28:
+                    raise ValueError("truncated or overlong varint")
+                byte = data[pos]
+                pos += 1
+                value |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            prev[c] = wrap32(prev[c] + unzigzag(value & 0xFFFFFFFF))
+            sample.append(f32(f32(prev[c]) * scale))
+        samples.append(tuple(sample))
+    return samples
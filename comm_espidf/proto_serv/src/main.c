@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <inttypes.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <unistd.h>
@@ -7,76 +9,134 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/event_groups.h"
-#include "esp_wifi.h"
-#include "esp_event.h"
 #include "nvs_flash.h"
 #include "esp_log.h"
 #include "esp_system.h"
 
-// Nanopb
-#include "sensor.pb.h"
+// Nanopb, and the Envelope framing shared with esp_server_protobuf
 #include "pb.h"
 #include "pb_decode.h"
+#include "pbuf_stream.h"
+#include "envelope.pb.h"
+#include "frame.h"
+#include "dispatch.h"
+
+#include "wifi_sta.h"
+#include "app_tasks.h"
+#include "telemetry_codec.h"
 
-// WiFi settings
-#define WIFI_SSID      "Mangifera Indica"
-#define WIFI_PASS      "azbe50000"
 #define PORT           3333
-#define WIFI_CONNECTED_BIT BIT0
+
+// SensorBatch channels, in telemetry_codec order
+#define BATCH_CHANNELS 2                      // temperature, humidity
+
+// Decode straight from lwIP pbufs via netconn instead of copying into rx_buffer
+#ifndef RX_ZERO_COPY
+#define RX_ZERO_COPY   1
+#endif
+
+#define TCP_SERVER_STACK_SIZE  4096
 
 static const char *TAG = "PROTOBUF_SERVER";
-static EventGroupHandle_t wifi_event_group;
-
-// ====== Wi-Fi event handler ======
-static void wifi_event_handler(void* arg, esp_event_base_t event_base,
-                               int32_t event_id, void* event_data) {
-    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        esp_wifi_connect();
-    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        ESP_LOGI(TAG, "Disconnected, retrying...");
-        esp_wifi_connect();
-    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
-        ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "Got IP: %s", ip4addr_ntoa((const ip4_addr_t *)&event->ip_info.ip));
-        xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
+
+// Envelope is sized for the largest payload, so keep it off the task stack
+static Envelope rx_env;
+
+// ====== Message handlers ======
+// Registered by Envelope payload tag; this node only takes sensor readings
+static bool handle_sensor(const Envelope *env, Envelope *reply, void *ctx) {
+    const SensorData *data = &env->payload.sensor;
+    ESP_LOGI(TAG, "Received Temp: %.2f, Humidity: %.2f", data->temperature, data->humidity);
+    return false;
+}
+
+static bool handle_batch(const Envelope *env, Envelope *reply, void *ctx) {
+    const SensorBatch *batch = &env->payload.batch;
+    telemetry_decoder_t dec;
+    if (!telemetry_decoder_init(&dec, batch->data.bytes, batch->data.size, BATCH_CHANNELS, batch->scale)) {
+        ESP_LOGE(TAG, "Batch has invalid scale %f", batch->scale);
+        return false;
+    }
+
+    float sample[BATCH_CHANNELS] = {0};
+    uint32_t count = 0;
+    while (telemetry_decode(&dec, sample)) {
+        count++;
     }
+
+    if (count != batch->count || dec.pos != dec.len) {
+        ESP_LOGW(TAG, "Batch truncated: decoded %" PRIu32 " of %" PRIu32 " samples", count, batch->count);
+    }
+    ESP_LOGI(TAG, "Received %" PRIu32 " samples in %u bytes, last Temp: %.2f, Humidity: %.2f",
+             count, (unsigned)batch->data.size, sample[0], sample[1]);
+    return false;
 }
 
-// ====== Wi-Fi Initialization ======
-void wifi_init_sta(void) {
-    wifi_event_group = xEventGroupCreate();
-    esp_netif_init();
-    esp_event_loop_create_default();
-    esp_netif_create_default_wifi_sta();
-
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    esp_wifi_init(&cfg);
-
-    esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
-                                        &wifi_event_handler, NULL, NULL);
-    esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
-                                        &wifi_event_handler, NULL, NULL);
-
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = WIFI_SSID,
-            .password = WIFI_PASS,
-            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
-        },
-    };
-
-    esp_wifi_set_mode(WIFI_MODE_STA);
-    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
-    esp_wifi_start();
-
-    ESP_LOGI(TAG, "Connecting to Wi-Fi...");
-    xEventGroupWaitBits(wifi_event_group, WIFI_CONNECTED_BIT, false, true, portMAX_DELAY);
+// Nothing here replies, so anything else is only reported
+static void handle_envelope(void) {
+    if (dispatch_envelope(&rx_env, NULL) == DISPATCH_UNHANDLED) {
+        ESP_LOGW(TAG, "No handler for payload %u", (unsigned)rx_env.which_payload);
+    }
 }
 
 // ====== TCP Server Task ======
+#if RX_ZERO_COPY
 void tcp_server_task(void *pvParameters) {
-    char rx_buffer[128];
+    struct netconn *listen_conn = netconn_new(NETCONN_TCP);
+    if (listen_conn == NULL) {
+        ESP_LOGE(TAG, "Failed to create netconn");
+        vTaskDelete(NULL);
+        return;
+    }
+
+    err_t err = netconn_bind(listen_conn, IP_ADDR_ANY, PORT);
+    if (err == ERR_OK) {
+        err = netconn_listen(listen_conn);
+    }
+    if (err != ERR_OK) {
+        ESP_LOGE(TAG, "Failed to listen on port %d: %d", PORT, err);
+        netconn_delete(listen_conn);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Server listening on port %d (zero-copy)", PORT);
+
+    while (1) {
+        struct netconn *conn;
+        if (netconn_accept(listen_conn, &conn) != ERR_OK) {
+            ESP_LOGE(TAG, "Accept failed");
+            continue;
+        }
+
+        pbuf_reader_t reader;
+        pbuf_reader_init_conn(&reader, conn);
+
+        // Frames follow each other until the client closes the connection
+        while (pbuf_reader_wait(&reader)) {
+            pb_istream_t stream = pbuf_istream(&reader, 0);
+            frame_status_t status = frame_read(&stream, &rx_env);
+            if (status != FRAME_OK) {
+                if (reader.eof) {
+                    ESP_LOGW(TAG, "Connection closed mid-frame");
+                } else if (status == FRAME_DECODE_ERROR) {
+                    ESP_LOGE(TAG, "Protobuf decode failed: %s", PB_GET_ERROR(&stream));
+                } else if (status == FRAME_TOO_LONG) {
+                    ESP_LOGE(TAG, "Frame exceeds %d bytes", FRAME_MAX_LEN);
+                }
+                break;
+            }
+            handle_envelope();
+        }
+
+        pbuf_reader_release(&reader);
+        netconn_close(conn);
+        netconn_delete(conn);
+    }
+}
+#else
+void tcp_server_task(void *pvParameters) {
+    uint8_t rx_buffer[FRAME_HEADER_LEN + FRAME_MAX_LEN];
     struct sockaddr_in server_addr, client_addr;
     socklen_t addr_len = sizeof(client_addr);
 
@@ -85,8 +145,19 @@ void tcp_server_task(void *pvParameters) {
     server_addr.sin_port = htons(PORT);
 
     int listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
-    bind(listen_sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
-    listen(listen_sock, 1);
+    if (listen_sock < 0) {
+        ESP_LOGE(TAG, "Failed to create socket: %d", errno);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    if (bind(listen_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 ||
+        listen(listen_sock, 1) < 0) {
+        ESP_LOGE(TAG, "Failed to listen on port %d: %d", PORT, errno);
+        close(listen_sock);
+        vTaskDelete(NULL);
+        return;
+    }
 
     ESP_LOGI(TAG, "Server listening on port %d", PORT);
 
@@ -97,28 +168,47 @@ void tcp_server_task(void *pvParameters) {
             continue;
         }
 
-        int len = recv(sock, rx_buffer, sizeof(rx_buffer), 0);
-        if (len > 0) {
-            SensorData data = SensorData_init_zero;
-            pb_istream_t stream = pb_istream_from_buffer((uint8_t *)rx_buffer, len);
+        // Frames follow each other until the client closes the connection
+        while (1) {
+            uint16_t msg_len;
+            if (recv(sock, rx_buffer, FRAME_HEADER_LEN, MSG_WAITALL) != FRAME_HEADER_LEN) break;
+            if (frame_header_parse(rx_buffer, &msg_len) != FRAME_OK) {
+                ESP_LOGE(TAG, "Frame exceeds %d bytes", FRAME_MAX_LEN);
+                break;
+            }
+            if (recv(sock, rx_buffer + FRAME_HEADER_LEN, msg_len, MSG_WAITALL) != msg_len) break;
 
-            if (pb_decode(&stream, SensorData_fields, &data)) {
-                ESP_LOGI(TAG, "Received Temp: %.2f, Humidity: %.2f", data.temperature, data.humidity);
-            } else {
+            size_t consumed;
+            if (frame_decode(rx_buffer, FRAME_HEADER_LEN + msg_len, &rx_env, &consumed) != FRAME_OK) {
                 ESP_LOGE(TAG, "Protobuf decode failed");
+                break;
             }
+            handle_envelope();
         }
 
         close(sock);
     }
-
-    close(listen_sock);
-    vTaskDelete(NULL);
 }
+#endif
+
+// ====== Task table ======
+#if CONFIG_APP_STATIC_ALLOC
+static StackType_t tcp_server_stack[TCP_SERVER_STACK_SIZE];
+static StaticTask_t tcp_server_tcb;
+#endif
+
+static app_task_t app_tasks[] = {
+    { tcp_server_task, "tcp_server", TCP_SERVER_STACK_SIZE, 5, tskNO_AFFINITY,
+      APP_TASK_BUFFERS(tcp_server_stack, tcp_server_tcb) },
+};
 
 // ====== app_main ======
 void app_main(void) {
     ESP_ERROR_CHECK(nvs_flash_init());
-    wifi_init_sta();  // Connect to WiFi
-    xTaskCreate(tcp_server_task, "tcp_server", 4096, NULL, 5, NULL);
+    dispatch_register(Envelope_sensor_tag, handle_sensor, NULL);
+    dispatch_register(Envelope_batch_tag, handle_batch, NULL);
+    wifi_sta_connect(portMAX_DELAY);  // Connect to WiFi
+    app_tasks_start(app_tasks, APP_TASK_COUNT(app_tasks));
+    ESP_ERROR_CHECK(app_tasks_start_memory_report());
+    app_tasks_log_memory();
 }
@@ -0,0 +1,93 @@
+#include <stdlib.h>
+#include "app_tasks.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "APP_TASKS";
+
+#define MAX_REGISTERED 4
+
+static const app_task_t *app_tasks;
+static int app_task_count;
+
+// Tasks created outside the table, such as component writer tasks
+static app_task_t registered[MAX_REGISTERED];
+static int registered_count;
+
+void app_tasks_start(app_task_t *tasks, int count)
+{
+    for (int i = 0; i < count; i++) {
+        app_task_t *task = &tasks[i];
+#if CONFIG_APP_STATIC_ALLOC
+        task->handle = xTaskCreateStaticPinnedToCore(task->fn, task->name, task->stack_size, NULL,
+                                                     task->priority, task->stack, task->tcb, task->core);
+#else
+        if (xTaskCreatePinnedToCore(task->fn, task->name, task->stack_size, NULL,
+                                    task->priority, &task->handle, task->core) != pdPASS) {
+            task->handle = NULL;
+        }
+#endif
+        // The app cannot run without its tasks, and the report would read a NULL handle
+        if (task->handle == NULL) {
+            ESP_LOGE(TAG, "Failed to create task %s (stack %lu)", task->name, (unsigned long)task->stack_size);
+            abort();
+        }
+    }
+
+    app_tasks = tasks;
+    app_task_count = count;
+}
+
+void app_tasks_register(const char *name, TaskHandle_t handle, uint32_t stack_size)
+{
+    if (handle == NULL || registered_count == MAX_REGISTERED) {
+        ESP_LOGW(TAG, "Task %s left out of the memory report", name);
+        return;
+    }
+
+    app_task_t *task = &registered[registered_count++];
+    task->name = name;
+    task->stack_size = stack_size;
+    task->handle = handle;
+}
+
+static void log_task(const app_task_t *task)
+{
+    ESP_LOGI(TAG, "Task %-20s stack %5lu, high-water %5u", task->name,
+             (unsigned long)task->stack_size, uxTaskGetStackHighWaterMark(task->handle));
+}
+
+void app_tasks_log_memory(void)
+{
+    ESP_LOGI(TAG, "Heap: free %u, min free %u, largest block %u",
+             heap_caps_get_free_size(MALLOC_CAP_8BIT),
+             heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+             heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+
+    for (int i = 0; i < app_task_count; i++) {
+        log_task(&app_tasks[i]);
+    }
+    for (int i = 0; i < registered_count; i++) {
+        log_task(&registered[i]);
+    }
+}
+
+static void memory_report_cb(void *arg)
+{
+    app_tasks_log_memory();
+}
+
+esp_err_t app_tasks_start_memory_report(void)
+{
+    const esp_timer_create_args_t timer_args = {
+        .callback = memory_report_cb,
+        .name = "mem_report",
+    };
+    esp_timer_handle_t timer;
+    esp_err_t err = esp_timer_create(&timer_args, &timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return esp_timer_start_periodic(timer, (uint64_t)CONFIG_APP_MEM_REPORT_INTERVAL_S * 1000 * 1000);
+}
@@ -0,0 +1,44 @@
+#ifndef APP_TASKS_H
+#define APP_TASKS_H
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+// Every task the app runs, with its stack budget in bytes
+typedef struct {
+    TaskFunction_t fn;
+    const char *name;
+    uint32_t stack_size;
+    UBaseType_t priority;
+    BaseType_t core;        // tskNO_AFFINITY to let the scheduler pick
+    StackType_t *stack;
+    StaticTask_t *tcb;
+    TaskHandle_t handle;
+} app_task_t;
+
+// Stack and TCB for a table entry; NULL when tasks come from the heap
+#if CONFIG_APP_STATIC_ALLOC
+#define APP_TASK_BUFFERS(stack, tcb) stack, &tcb
+#else
+#define APP_TASK_BUFFERS(stack, tcb) NULL, NULL
+#endif
+
+#define APP_TASK_COUNT(tasks) ((int)(sizeof(tasks) / sizeof((tasks)[0])))
+
+// Create every task in the table, aborting if one cannot be created. The
+// table is kept for the memory report.
+void app_tasks_start(app_task_t *tasks, int count);
+
+// Add a task created elsewhere, such as a component's own, to the memory
+// report. A NULL handle is left out with a warning.
+void app_tasks_register(const char *name, TaskHandle_t handle, uint32_t stack_size);
+
+// Log heap usage and the stack high-water mark of every task
+void app_tasks_log_memory(void);
+
+// Log the memory report every CONFIG_APP_MEM_REPORT_INTERVAL_S seconds
+esp_err_t app_tasks_start_memory_report(void);
+
+#endif
@@ -0,0 +1,58 @@
+#include "buzzer.h"
+#include "driver/ledc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Timer 0 / channel 0 belong to the stepper step generator
+#define LEDC_TIMER              LEDC_TIMER_1
+#define LEDC_MODE               LEDC_LOW_SPEED_MODE
+#define LEDC_CHANNEL            LEDC_CHANNEL_1
+#define LEDC_DUTY_RES           LEDC_TIMER_13_BIT
+#define LEDC_DUTY_HALF          4096
+
+esp_err_t buzzer_init(void)
+{
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode       = LEDC_MODE,
+        .timer_num        = LEDC_TIMER,
+        .duty_resolution  = LEDC_DUTY_RES,
+        .freq_hz          = 1000,
+        .clk_cfg          = LEDC_AUTO_CLK
+    };
+    esp_err_t err = ledc_timer_config(&ledc_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ledc_channel_config_t ledc_channel = {
+        .speed_mode     = LEDC_MODE,
+        .channel        = LEDC_CHANNEL,
+        .timer_sel      = LEDC_TIMER,
+        .intr_type      = LEDC_INTR_DISABLE,
+        .gpio_num       = CONFIG_BUZZER_GPIO,
+        .duty           = 0,
+        .hpoint         = 0
+    };
+    return ledc_channel_config(&ledc_channel);
+}
+
+void buzzer_start(uint32_t frequency)
+{
+    ledc_set_freq(LEDC_MODE, LEDC_TIMER, frequency);
+
+    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, LEDC_DUTY_HALF);
+    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+}
+
+void buzzer_stop(void)
+{
+    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0);
+    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+}
+
+void buzzer_beep(uint32_t frequency, uint32_t duration_ms)
+{
+    buzzer_start(frequency);
+    vTaskDelay(pdMS_TO_TICKS(duration_ms));
+    buzzer_stop();
+}
@@ -0,0 +1,17 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Set up the LEDC tone generator on CONFIG_BUZZER_GPIO, silent until started
+esp_err_t buzzer_init(void);
+
+// Sound frequency until buzzer_stop()
+void buzzer_start(uint32_t frequency);
+void buzzer_stop(void);
+
+// Sound frequency for duration_ms, blocking the calling task
+void buzzer_beep(uint32_t frequency, uint32_t duration_ms);
+
+#endif
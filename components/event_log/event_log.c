@@ -0,0 +1,324 @@
+#include "event_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#define WRITER_PRIORITY     2
+
+// Writer notification bits
+#define NOTIFY_FULL         (1 << 0)
+#define NOTIFY_FLUSH        (1 << 1)
+
+#define HDR_LEN             sizeof(event_log_sector_hdr_t)
+
+static const char *TAG = "EVENT_LOG";
+
+static const esp_partition_t *partition;
+static uint32_t sector_count;
+
+// Ring position, guarded by flash_lock. The readable log is the ring_len
+// sectors from tail, oldest first; tail always holds a valid header, whose
+// seq is tail_seq.
+static uint32_t head;           // next sector to write
+static uint32_t tail;
+static uint32_t ring_len;
+static uint32_t tail_seq;
+static uint32_t next_seq;
+static uint16_t boot;
+
+// Double-buffered staging, guarded by stage_lock. Recorders fill the active
+// sector while the writer task puts the pending one on flash.
+static uint8_t staging[2][EVENT_LOG_SECTOR_SIZE];
+static int active;
+static size_t fill = HDR_LEN;
+static int pending = -1;
+static size_t pending_fill;
+static uint32_t dropped;
+static portMUX_TYPE stage_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t writer_task;
+static StackType_t writer_stack[EVENT_LOG_WRITER_STACK_SIZE];
+static StaticTask_t writer_tcb;
+
+static SemaphoreHandle_t flash_lock;
+static StaticSemaphore_t flash_lock_buf;
+static SemaphoreHandle_t flush_done;
+static StaticSemaphore_t flush_done_buf;
+
+// Hand the active sector to the writer. Nothing happens while the writer
+// still holds the other one or when the active sector has no records.
+// Call with stage_lock held.
+static bool swap_staging(void)
+{
+    if (pending >= 0 || fill == HDR_LEN) {
+        return false;
+    }
+
+    pending = active;
+    pending_fill = fill;
+    active ^= 1;
+    fill = HDR_LEN;
+    return true;
+}
+
+void event_log_record(event_type_t type, const void *payload, uint8_t len)
+{
+    if (writer_task == NULL || len > EVENT_LOG_PAYLOAD_MAX) {
+        return;
+    }
+
+    uint32_t time_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    bool full = false;
+
+    portENTER_CRITICAL(&stage_lock);
+    if (!event_log_append(staging[active], EVENT_LOG_SECTOR_SIZE, &fill, type, time_ms, payload, len)) {
+        // Active sector is full: move on to the other one if the writer has freed it
+        full = swap_staging();
+        if (!full || !event_log_append(staging[active], EVENT_LOG_SECTOR_SIZE, &fill, type, time_ms, payload, len)) {
+            dropped++;
+        }
+    }
+    portEXIT_CRITICAL(&stage_lock);
+
+    if (full) {
+        xTaskNotify(writer_task, NOTIFY_FULL, eSetBits);
+    }
+}
+
+// Read a sector header, false if the sector does not hold one (erased, or
+// torn by a power loss mid-write). Record CRCs are left to the decoder.
+static bool read_header(uint32_t sector, event_log_sector_hdr_t *hdr)
+{
+    return esp_partition_read(partition, sector * EVENT_LOG_SECTOR_SIZE, hdr, sizeof(*hdr)) == ESP_OK &&
+           hdr->magic == EVENT_LOG_MAGIC && hdr->used <= EVENT_LOG_SECTOR_SIZE - HDR_LEN;
+}
+
+// Move tail past sectors without a valid header, so offset 0 is always a
+// real sector and tail_seq its sequence number. Call with flash_lock held.
+static void trim_tail(void)
+{
+    event_log_sector_hdr_t hdr;
+    while (ring_len > 0 && !read_header(tail, &hdr)) {
+        tail = (tail + 1) % sector_count;
+        ring_len--;
+    }
+    if (ring_len > 0) {
+        tail_seq = hdr.seq;
+    }
+}
+
+static void write_sector(uint8_t *buf, size_t len)
+{
+    event_log_sector_hdr_t hdr = {
+        .magic = EVENT_LOG_MAGIC,
+        .boot = boot,
+        .used = len - HDR_LEN,
+        .crc = esp_rom_crc32_le(0, buf + HDR_LEN, len - HDR_LEN),
+    };
+
+    xSemaphoreTake(flash_lock, portMAX_DELAY);
+    hdr.seq = next_seq;
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    // A full ring overwrites its oldest sector, which leaves the log first
+    if (ring_len == sector_count) {
+        tail = (tail + 1) % sector_count;
+        ring_len--;
+        trim_tail();
+    }
+
+    size_t offset = head * EVENT_LOG_SECTOR_SIZE;
+    esp_err_t err = esp_partition_erase_range(partition, offset, EVENT_LOG_SECTOR_SIZE);
+    if (err == ESP_OK) {
+        err = esp_partition_write(partition, offset, buf, len);
+    }
+    if (err == ESP_OK) {
+        if (ring_len == 0) {
+            tail = head;
+            tail_seq = next_seq;
+        }
+        ring_len++;
+        next_seq++;
+        head = (head + 1) % sector_count;
+    }
+    xSemaphoreGive(flash_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sector %lu write failed: %s", (unsigned long)(offset / EVENT_LOG_SECTOR_SIZE),
+                 esp_err_to_name(err));
+    }
+}
+
+// Write out the sector the recorders handed over, if there is one
+static void write_pending(void)
+{
+    if (pending < 0) {
+        return;
+    }
+
+    write_sector(staging[pending], pending_fill);
+
+    portENTER_CRITICAL(&stage_lock);
+    pending = -1;
+    portEXIT_CRITICAL(&stage_lock);
+}
+
+static void writer(void *arg)
+{
+    while (1) {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, pdMS_TO_TICKS(CONFIG_EVENT_LOG_FLUSH_INTERVAL_S * 1000));
+
+        // A full sector goes out first
+        write_pending();
+
+        // A flush or a quiet interval also writes out the partly filled
+        // sector, at most once per wakeup; records staged meanwhile wait for
+        // the next one. If recorders handed over a full sector in between,
+        // that goes out instead.
+        if (bits != NOTIFY_FULL) {
+            portENTER_CRITICAL(&stage_lock);
+            swap_staging();
+            portEXIT_CRITICAL(&stage_lock);
+            write_pending();
+        }
+
+        if (bits & NOTIFY_FLUSH) {
+            xSemaphoreGive(flush_done);
+        }
+    }
+}
+
+esp_err_t event_log_flush(void)
+{
+    if (writer_task == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Every flush uses up a sector, so one with nothing to write is skipped
+    portENTER_CRITICAL(&stage_lock);
+    bool staged = fill > HDR_LEN || pending >= 0;
+    portEXIT_CRITICAL(&stage_lock);
+    if (!staged) {
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(flush_done, 0);
+    xTaskNotify(writer_task, NOTIFY_FLUSH, eSetBits);
+    return xSemaphoreTake(flush_done, pdMS_TO_TICKS(1000)) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+uint32_t event_log_size(uint32_t *first_seq)
+{
+    if (partition == NULL) {
+        return 0;
+    }
+
+    xSemaphoreTake(flash_lock, portMAX_DELAY);
+    uint32_t sectors = ring_len;
+    if (first_seq != NULL) {
+        *first_seq = tail_seq;
+    }
+    xSemaphoreGive(flash_lock);
+    return sectors * EVENT_LOG_SECTOR_SIZE;
+}
+
+esp_err_t event_log_read(uint32_t offset, void *buf, size_t len, uint32_t *first_seq)
+{
+    if (partition == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(flash_lock, portMAX_DELAY);
+    if (first_seq != NULL) {
+        *first_seq = tail_seq;
+    }
+    uint32_t size = ring_len * EVENT_LOG_SECTOR_SIZE;
+    esp_err_t err = (offset > size || len > size - offset) ? ESP_ERR_INVALID_SIZE : ESP_OK;
+
+    // Sectors are contiguous on flash but the oldest may sit anywhere in the ring
+    uint8_t *out = buf;
+    while (err == ESP_OK && len > 0) {
+        uint32_t sector = (tail + offset / EVENT_LOG_SECTOR_SIZE) % sector_count;
+        uint32_t in_sector = offset % EVENT_LOG_SECTOR_SIZE;
+        size_t n = EVENT_LOG_SECTOR_SIZE - in_sector;
+        if (n > len) n = len;
+
+        err = esp_partition_read(partition, sector * EVENT_LOG_SECTOR_SIZE + in_sector, out, n);
+        out += n;
+        offset += n;
+        len -= n;
+    }
+    xSemaphoreGive(flash_lock);
+    return err;
+}
+
+uint32_t event_log_dropped(void)
+{
+    return dropped;
+}
+
+TaskHandle_t event_log_writer_task(void)
+{
+    return writer_task;
+}
+
+esp_err_t event_log_init(void)
+{
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                         CONFIG_EVENT_LOG_PARTITION_LABEL);
+    if (partition == NULL) {
+        ESP_LOGE(TAG, "No \"%s\" partition", CONFIG_EVENT_LOG_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    sector_count = partition->size / EVENT_LOG_SECTOR_SIZE;
+
+    // Resume after the sector with the highest sequence number
+    bool found = false;
+    uint32_t newest = 0;
+    event_log_sector_hdr_t newest_hdr = {0};
+    for (uint32_t i = 0; i < sector_count; i++) {
+        event_log_sector_hdr_t hdr;
+        if (read_header(i, &hdr) && (!found || hdr.seq > newest_hdr.seq)) {
+            found = true;
+            newest = i;
+            newest_hdr = hdr;
+        }
+    }
+
+    if (found) {
+        head = (newest + 1) % sector_count;
+        next_seq = newest_hdr.seq + 1;
+        boot = newest_hdr.boot + 1;
+
+        // The log starts at the first valid sector after the newest one: sector
+        // 0 before the ring has gone round, else the oldest survivor. Invalid
+        // sectors in between are erased or torn ones.
+        tail = head;
+        ring_len = sector_count;
+        trim_tail();
+
+        uint32_t invalid = 0;
+        for (uint32_t i = 0; i < ring_len; i++) {
+            event_log_sector_hdr_t hdr;
+            invalid += !read_header((tail + i) % sector_count, &hdr);
+        }
+        if (invalid > 0) {
+            ESP_LOGW(TAG, "Sectors without a valid header inside the log: %lu", (unsigned long)invalid);
+        }
+    }
+
+    flash_lock = xSemaphoreCreateMutexStatic(&flash_lock_buf);
+    flush_done = xSemaphoreCreateBinaryStatic(&flush_done_buf);
+    writer_task = xTaskCreateStatic(writer, "event_log", EVENT_LOG_WRITER_STACK_SIZE, NULL, WRITER_PRIORITY,
+                                    writer_stack, &writer_tcb);
+    configASSERT(writer_task != NULL);
+
+    ESP_LOGI(TAG, "%lu sectors, boot %u, next seq %lu at sector %lu, %lu in the log", (unsigned long)sector_count,
+             boot, (unsigned long)next_seq, (unsigned long)head, (unsigned long)ring_len);
+    return ESP_OK;
+}
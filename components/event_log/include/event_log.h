@@ -0,0 +1,62 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "event_log_format.h"
+
+// Stack of the writer task, in bytes
+#define EVENT_LOG_WRITER_STACK_SIZE 3072
+
+// Find the log partition, resume after the newest sector and start the
+// writer task. Until this succeeds, records are dropped.
+esp_err_t event_log_init(void);
+
+// Stage a record in RAM. Never waits on flash: when both staging sectors
+// are full the record is dropped and counted instead.
+void event_log_record(event_type_t type, const void *payload, uint8_t len);
+
+// Write the partly filled staging sector now and wait for it to land.
+// Returns at once if no records have been staged since the last write.
+esp_err_t event_log_flush(void);
+
+// Bytes of log available to event_log_read(), oldest sector first. If
+// first_seq is not NULL it is set to the sequence number of the oldest
+// valid sector, which offsets count from. Erased or torn sectors are
+// skipped at that end of the ring; one further in stays in the log, and
+// the decoder reports it by its header.
+uint32_t event_log_size(uint32_t *first_seq);
+
+// Copy len bytes of the log starting at offset, in the same order. Once the
+// ring is full, every sector written moves the oldest one on, so a caller
+// paging through the log compares first_seq between reads.
+esp_err_t event_log_read(uint32_t offset, void *buf, size_t len, uint32_t *first_seq);
+
+// Records dropped because the writer fell behind
+uint32_t event_log_dropped(void);
+
+// The writer task, for stack reports. NULL until event_log_init() succeeds.
+TaskHandle_t event_log_writer_task(void);
+
+static inline void event_log_ir(uint16_t count)
+{
+    event_ir_t ev = { .count = count };
+    event_log_record(EVENT_IR_DETECTION, &ev, sizeof(ev));
+}
+
+static inline void event_log_motor(int32_t steps, uint32_t freq_hz)
+{
+    event_motor_t ev = { .steps = steps, .freq_hz = freq_hz };
+    event_log_record(EVENT_MOTOR_MOVE, &ev, sizeof(ev));
+}
+
+static inline void event_log_command(uint32_t id, float speed, float steering, bool enable)
+{
+    event_command_t ev = { .id = id, .speed = speed, .steering = steering, .enable = enable };
+    event_log_record(EVENT_COMMAND, &ev, sizeof(ev));
+}
+
+#endif
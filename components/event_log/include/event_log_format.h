@@ -0,0 +1,72 @@
+#ifndef EVENT_LOG_FORMAT_H
+#define EVENT_LOG_FORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// On-flash layout of the event log, shared with event_log_decode.py.
+// Kept free of ESP-IDF headers so it builds anywhere.
+//
+// The partition is a ring of sectors. Each sector starts with a header,
+// followed by used bytes of back-to-back records. All fields are little-endian.
+
+#define EVENT_LOG_SECTOR_SIZE 4096
+#define EVENT_LOG_MAGIC       0x474C5645    // "EVLG"
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t seq;       // one more than the previous sector written, across reboots
+    uint16_t boot;      // boot count; record times restart at each boot
+    uint16_t used;      // bytes of records after the header
+    uint32_t crc;       // CRC-32 of those bytes
+} event_log_sector_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;       // event_type_t
+    uint8_t len;        // payload bytes after this header
+    uint32_t time_ms;   // since boot
+} event_log_rec_hdr_t;
+
+typedef enum {
+    EVENT_IR_DETECTION = 1,
+    EVENT_MOTOR_MOVE   = 2,
+    EVENT_COMMAND      = 3,
+} event_type_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t count;     // detections counted so far
+} event_ir_t;
+
+typedef struct __attribute__((packed)) {
+    int32_t steps;      // negative for reverse
+    uint32_t freq_hz;   // step rate
+} event_motor_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t id;
+    float speed;
+    float steering;
+    uint8_t enable;
+} event_command_t;
+
+#define EVENT_LOG_PAYLOAD_MAX 32
+
+// Append one record to a sector buffer of cap bytes at *pos.
+// Returns false, leaving *pos alone, if it does not fit.
+static inline bool event_log_append(uint8_t *buf, size_t cap, size_t *pos, uint8_t type,
+                                    uint32_t time_ms, const void *payload, uint8_t len)
+{
+    event_log_rec_hdr_t hdr = { .type = type, .len = len, .time_ms = time_ms };
+    if (*pos + sizeof(hdr) + len > cap) {
+        return false;
+    }
+
+    memcpy(buf + *pos, &hdr, sizeof(hdr));
+    memcpy(buf + *pos + sizeof(hdr), payload, len);
+    *pos += sizeof(hdr) + len;
+    return true;
+}
+
+#endif
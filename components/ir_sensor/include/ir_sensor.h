@@ -0,0 +1,22 @@
+#ifndef IR_SENSOR_H
+#define IR_SENSOR_H
+
+#include <stdbool.h>
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+#define IR_SENSOR_PIN ((gpio_num_t)CONFIG_IR_SENSOR_GPIO)
+
+// Configure the sensor pin as an input with the given interrupt type
+esp_err_t ir_sensor_init(gpio_int_type_t intr_type);
+
+// Attach isr to the sensor pin, installing the GPIO ISR service if needed
+esp_err_t ir_sensor_add_isr(gpio_isr_t isr, void *arg);
+
+// The sensor output goes low when an object is in view
+static inline bool ir_sensor_object_detected(void)
+{
+    return gpio_get_level(IR_SENSOR_PIN) == 0;
+}
+
+#endif
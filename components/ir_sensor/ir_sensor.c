@@ -0,0 +1,28 @@
+#include "ir_sensor.h"
+
+esp_err_t ir_sensor_init(gpio_int_type_t intr_type)
+{
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << IR_SENSOR_PIN),
+        .mode = GPIO_MODE_INPUT,
+#if CONFIG_IR_SENSOR_PULLUP
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+#else
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+#endif
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = intr_type,
+    };
+    return gpio_config(&io_conf);
+}
+
+esp_err_t ir_sensor_add_isr(gpio_isr_t isr, void *arg)
+{
+    // Another component may already have installed the service
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+
+    return gpio_isr_handler_add(IR_SENSOR_PIN, isr, arg);
+}
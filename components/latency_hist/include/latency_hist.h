@@ -0,0 +1,31 @@
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+
+#define LATENCY_HIST_BUCKETS 16
+
+// Log2 histogram of latencies in microseconds. Bucket 0 counts 0 us,
+// bucket i counts [2^(i-1), 2^i) us and the last bucket everything above.
+//
+// A single writer records without locking; readers take consistent copies
+// with latency_hist_snapshot(), retrying while a record is in progress.
+typedef struct {
+    uint32_t seq;       // odd while the writer is updating
+    uint32_t count;
+    uint32_t max_us;
+    uint32_t buckets[LATENCY_HIST_BUCKETS];
+} latency_hist_t;
+
+#define LATENCY_HIST_INIT {0}
+
+// Add one sample. Only one task may record into a given histogram.
+void latency_hist_record(latency_hist_t *hist, uint32_t us);
+
+// Copy a consistent view of hist into out
+void latency_hist_snapshot(const latency_hist_t *hist, latency_hist_t *out);
+
+// Bucket a latency falls into
+int latency_hist_bucket(uint32_t us);
+
+#endif
@@ -0,0 +1,48 @@
+#include "latency_hist.h"
+
+int latency_hist_bucket(uint32_t us)
+{
+    if (us == 0) {
+        return 0;
+    }
+
+    int bucket = 32 - __builtin_clz(us);
+    return bucket < LATENCY_HIST_BUCKETS ? bucket : LATENCY_HIST_BUCKETS - 1;
+}
+
+void latency_hist_record(latency_hist_t *hist, uint32_t us)
+{
+    int bucket = latency_hist_bucket(us);
+    uint32_t seq = __atomic_load_n(&hist->seq, __ATOMIC_RELAXED);
+
+    // Mark the update as in progress before touching any counter
+    __atomic_store_n(&hist->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    __atomic_store_n(&hist->buckets[bucket], hist->buckets[bucket] + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->count, hist->count + 1, __ATOMIC_RELAXED);
+    if (us > hist->max_us) {
+        __atomic_store_n(&hist->max_us, us, __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&hist->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+void latency_hist_snapshot(const latency_hist_t *hist, latency_hist_t *out)
+{
+    uint32_t seq;
+
+    do {
+        seq = __atomic_load_n(&hist->seq, __ATOMIC_ACQUIRE);
+
+        out->count = __atomic_load_n(&hist->count, __ATOMIC_RELAXED);
+        out->max_us = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+        for (int i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+            out->buckets[i] = __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&hist->seq, __ATOMIC_RELAXED));
+
+    out->seq = seq;
+}
@@ -0,0 +1,39 @@
+#ifndef PBUF_READER_H
+#define PBUF_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <lwip/api.h>
+#include <lwip/pbuf.h>
+
+// Sequential reader over lwIP pbuf chains, so received segments can be
+// parsed in place instead of first being copied into a contiguous buffer.
+// pbuf_stream.h wraps it as a nanopb input stream.
+typedef struct {
+    struct netconn *conn;   // refill source, NULL for a fixed chain
+    struct netbuf *nb;      // netbuf owning the current chain
+    struct pbuf *p;         // current segment
+    u16_t off;              // read offset into p
+    bool eof;               // ran out of data before a read completed
+    int64_t rx_us;          // when the current netbuf was received
+} pbuf_reader_t;
+
+// Read from a connected netconn, pulling in further netbufs as needed
+void pbuf_reader_init_conn(pbuf_reader_t *reader, struct netconn *conn);
+
+// Read from an existing chain; the chain stays owned by the caller
+void pbuf_reader_init_chain(pbuf_reader_t *reader, struct pbuf *p);
+
+// Free any netbuf still held by the reader
+void pbuf_reader_release(pbuf_reader_t *reader);
+
+// Make sure there is data to read, receiving the next netbuf if nothing is
+// buffered. Returns false once the connection is closed or the chain ends.
+bool pbuf_reader_wait(pbuf_reader_t *reader);
+
+// Copy count bytes into buf, or skip them if buf is NULL. Returns false
+// and sets eof if the data runs out first.
+bool pbuf_reader_read(pbuf_reader_t *reader, uint8_t *buf, size_t count);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PBUF_STREAM_H
+#define PBUF_STREAM_H
+
+#include <pb_decode.h>
+#include "pbuf_reader.h"
+
+// nanopb input stream that reads straight out of lwIP pbuf chains, so
+// messages are decoded from the received segments without first being
+// copied into a contiguous buffer.
+//
+// nanopb comes from each app's lib_deps and is not visible to components,
+// so this part stays inline and is compiled by the apps that include it.
+
+static inline bool pbuf_istream_read(pb_istream_t *stream, pb_byte_t *buf, size_t count)
+{
+    if (!pbuf_reader_read((pbuf_reader_t *)stream->state, buf, count)) {
+        stream->bytes_left = 0; // EOF
+        return false;
+    }
+    return true;
+}
+
+// Stream limited to bytes_left; running out of data marks the reader as EOF
+static inline pb_istream_t pbuf_istream(pbuf_reader_t *reader, size_t bytes_left)
+{
+    pb_istream_t stream = {
+        .callback = pbuf_istream_read,
+        .state = reader,
+        .bytes_left = bytes_left,
+    };
+    return stream;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "pbuf_reader.h"
+
+void pbuf_reader_init_conn(pbuf_reader_t *reader, struct netconn *conn)
+{
+    reader->conn = conn;
+    reader->nb = NULL;
+    reader->p = NULL;
+    reader->off = 0;
+    reader->eof = false;
+    reader->rx_us = 0;
+}
+
+void pbuf_reader_init_chain(pbuf_reader_t *reader, struct pbuf *p)
+{
+    reader->conn = NULL;
+    reader->nb = NULL;
+    reader->p = p;
+    reader->off = 0;
+    reader->eof = false;
+    reader->rx_us = esp_timer_get_time();
+}
+
+void pbuf_reader_release(pbuf_reader_t *reader)
+{
+    if (reader->nb != NULL) {
+        netbuf_delete(reader->nb);
+        reader->nb = NULL;
+    }
+    reader->p = NULL;
+    reader->off = 0;
+}
+
+static bool pbuf_reader_refill(pbuf_reader_t *reader)
+{
+    if (reader->conn == NULL) {
+        return false;
+    }
+
+    pbuf_reader_release(reader);
+    if (netconn_recv(reader->conn, &reader->nb) != ERR_OK) {
+        reader->nb = NULL;
+        return false;
+    }
+
+    reader->p = reader->nb->p;
+    reader->rx_us = esp_timer_get_time();
+    return true;
+}
+
+bool pbuf_reader_wait(pbuf_reader_t *reader)
+{
+    if (reader->p == NULL && !pbuf_reader_refill(reader)) {
+        reader->eof = true;
+        return false;
+    }
+    return true;
+}
+
+bool pbuf_reader_read(pbuf_reader_t *reader, uint8_t *buf, size_t count)
+{
+    while (count > 0) {
+        if (!pbuf_reader_wait(reader)) {
+            return false;
+        }
+
+        size_t avail = reader->p->len - reader->off;
+        size_t n = count < avail ? count : avail;
+
+        if (buf != NULL) {
+            memcpy(buf, (const uint8_t *)reader->p->payload + reader->off, n);
+            buf += n;
+        }
+        reader->off += n;
+        count -= n;
+
+        // Step to the next segment of the chain
+        if (reader->off == reader->p->len) {
+            reader->p = reader->p->next;
+            reader->off = 0;
+        }
+    }
+
+    return true;
+}
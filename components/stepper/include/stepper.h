@@ -0,0 +1,55 @@
+#ifndef STEPPER_H
+#define STEPPER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "stepper_math.h"
+
+#define STEPPER_STEP_PIN ((gpio_num_t)CONFIG_STEPPER_STEP_GPIO)
+#define STEPPER_DIR_PIN  ((gpio_num_t)CONFIG_STEPPER_DIR_GPIO)
+#define STEPPER_EN_PIN   ((gpio_num_t)CONFIG_STEPPER_EN_GPIO)
+
+#define STEPPER_STEPS_FOR(deg) STEPPER_STEPS_FOR_DEG(CONFIG_STEPPER_MICROSTEPS_PER_REV, deg)
+
+// Configure STEP, DIR and EN as outputs with the driver disabled
+esp_err_t stepper_init(void);
+
+// EN is active low
+void stepper_enable(bool enable);
+
+void stepper_set_direction(bool forward);
+
+// Busy-wait, for step timing below the tick rate
+void stepper_delay_us(uint32_t us);
+
+// Bit-bang steps on the STEP pin, holding each level for half_period_us
+void stepper_step_blocking(int steps, uint32_t half_period_us);
+
+// Drive STEP from LEDC at freq_hz instead of bit-banging. Idle until started.
+esp_err_t stepper_pulse_init(uint32_t freq_hz);
+void stepper_pulse_start(void);
+void stepper_pulse_stop(void);
+
+// Called from the ramp timer when the step rate first reflects a new speed
+// command: requested_us is when it was set, applied_us when the timer took it
+typedef void (*stepper_velocity_cb_t)(int64_t requested_us, int64_t applied_us);
+
+// Velocity mode: a hardware timer drives STEP at a rate that ramps towards the
+// last commanded speed. Period changes take effect between pulses, never mid-pulse.
+// It drives the STEP pin itself, so don't mix it with stepper_pulse_*().
+esp_err_t stepper_velocity_start(stepper_velocity_cb_t on_apply);
+
+// Set the target speed in [-1, 1]; cheap enough to call for every command
+void stepper_velocity_set_speed(float speed);
+
+// Velocity mode drives EN too. Enabling raises it and ramps up from rest;
+// disabling ramps down to a stop and drops EN after the last pulse. Don't
+// call stepper_enable() alongside it.
+void stepper_velocity_enable(bool enable);
+
+// Signed step rate the ramp has reached, in Hz
+float stepper_velocity_hz(void);
+
+#endif
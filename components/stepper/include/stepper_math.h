@@ -0,0 +1,76 @@
+#ifndef STEPPER_MATH_H
+#define STEPPER_MATH_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Step and timing arithmetic, kept free of driver headers so it builds anywhere
+
+// Microsteps needed to turn by degrees, e.g. 1066 for 60 degrees at 6400 per rev
+#define STEPPER_STEPS_FOR_DEG(microsteps_per_rev, deg) (((microsteps_per_rev) * (deg)) / 360)
+
+// How long a move of steps takes at freq_hz, in milliseconds
+static inline uint32_t stepper_move_duration_ms(uint32_t steps, uint32_t freq_hz)
+{
+    return freq_hz == 0 ? 0 : (uint32_t)(((uint64_t)steps * 1000) / freq_hz);
+}
+
+// Signed step rate for a speed command, where +/-1 is full speed either way.
+// Out-of-range commands are clamped and NaN stops the motor.
+static inline float stepper_speed_to_hz(float speed, float max_hz)
+{
+    if (isnan(speed)) return 0.0f;
+    if (speed > 1.0f) speed = 1.0f;
+    if (speed < -1.0f) speed = -1.0f;
+    return speed * max_hz;
+}
+
+// Move the rate from current towards target by at most max_delta, so
+// acceleration stays bounded however abruptly the target jumps
+static inline float stepper_rate_limit(float current, float target, float max_delta)
+{
+    if (target > current + max_delta) return current + max_delta;
+    if (target < current - max_delta) return current - max_delta;
+    return target;
+}
+
+// Timer ticks per half STEP period at rate hz of either sign. Rates below
+// min_hz give 0, which means stopped.
+static inline uint32_t stepper_half_period_ticks(float hz, float min_hz, uint32_t tick_hz)
+{
+    float mag = fabsf(hz);
+    if (mag < min_hz || mag == 0.0f) return 0;
+
+    uint32_t ticks = (uint32_t)(tick_hz / (2.0f * mag) + 0.5f);
+    return ticks > 0 ? ticks : 1;
+}
+
+// One velocity ramp update: move *rate_hz towards target_hz by at most
+// max_delta and return the half period for the step timer, 0 to stop.
+// Nothing steps slower than min_hz, so the rate skips the band below it
+// without breaking the limit: it stops if it can, otherwise it holds min_hz
+// for one more period. DIR only changes while the timer is stopped, so on a
+// reversal the rate is held at 0 until the ISR has stopped it (running
+// false, forward the direction it ran in) and the new direction ramps up
+// from rest. Needs min_hz <= max_delta.
+static inline uint32_t stepper_ramp_update(float *rate_hz, float target_hz, float max_delta, bool running,
+                                           bool forward, float min_hz, uint32_t tick_hz)
+{
+    float rate = stepper_rate_limit(*rate_hz, target_hz, max_delta);
+    if (rate != 0.0f && fabsf(rate) < min_hz) {
+        if (fabsf(*rate_hz) <= max_delta) {
+            rate = 0.0f;
+        } else {
+            rate = rate > 0 ? min_hz : -min_hz;
+        }
+    }
+    if (rate != 0.0f && running && (rate > 0) != forward) {
+        rate = 0.0f;
+    }
+
+    *rate_hz = rate;
+    return stepper_half_period_ticks(rate, min_hz, tick_hz);
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "stepper.h"
+#include "driver/ledc.h"
+#include "esp_timer.h"
+
+// The buzzer component uses timer 1 / channel 1, so both can run together
+#define STEPPER_LEDC_TIMER   LEDC_TIMER_0
+#define STEPPER_LEDC_CHANNEL LEDC_CHANNEL_0
+
+esp_err_t stepper_init(void)
+{
+    gpio_config_t io_conf = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = (1ULL << STEPPER_STEP_PIN) | (1ULL << STEPPER_DIR_PIN) | (1ULL << STEPPER_EN_PIN),
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE
+    };
+    esp_err_t err = gpio_config(&io_conf);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    gpio_set_level(STEPPER_EN_PIN, 1);
+    return ESP_OK;
+}
+
+void stepper_enable(bool enable)
+{
+    gpio_set_level(STEPPER_EN_PIN, enable ? 0 : 1);
+}
+
+void stepper_set_direction(bool forward)
+{
+    gpio_set_level(STEPPER_DIR_PIN, forward ? 1 : 0);
+}
+
+void stepper_delay_us(uint32_t us)
+{
+    int64_t start = esp_timer_get_time();
+    while ((esp_timer_get_time() - start) < us);
+}
+
+void stepper_step_blocking(int steps, uint32_t half_period_us)
+{
+    for (int i = 0; i < steps; i++) {
+        gpio_set_level(STEPPER_STEP_PIN, 1);
+        stepper_delay_us(half_period_us);
+        gpio_set_level(STEPPER_STEP_PIN, 0);
+        stepper_delay_us(half_period_us);
+    }
+}
+
+esp_err_t stepper_pulse_init(uint32_t freq_hz)
+{
+    ledc_timer_config_t ledc_timer = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .timer_num = STEPPER_LEDC_TIMER,
+        .duty_resolution = LEDC_TIMER_1_BIT,
+        .freq_hz = freq_hz,
+        .clk_cfg = LEDC_AUTO_CLK
+    };
+    esp_err_t err = ledc_timer_config(&ledc_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    ledc_channel_config_t ledc_channel = {
+        .gpio_num = STEPPER_STEP_PIN,
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = STEPPER_LEDC_CHANNEL,
+        .timer_sel = STEPPER_LEDC_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+        .flags.output_invert = 0
+    };
+    return ledc_channel_config(&ledc_channel);
+}
+
+void stepper_pulse_start(void)
+{
+    // 1 of 2 at 1-bit resolution is a 50% square wave
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, STEPPER_LEDC_CHANNEL, 1);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, STEPPER_LEDC_CHANNEL);
+}
+
+void stepper_pulse_stop(void)
+{
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, STEPPER_LEDC_CHANNEL, 0);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, STEPPER_LEDC_CHANNEL);
+}
@@ -0,0 +1,181 @@
+#include "stepper.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/gptimer.h"
+#include "hal/gpio_ll.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+
+// 0.1 us per tick: a half period at the 10.66 kHz default top rate is 469
+// ticks, so the step rate resolves to ~0.2% (1 us ticks left it at ~2%).
+// The slowest rate, 50 Hz, still only needs 100000 ticks.
+#define TIMER_RESOLUTION_HZ 10000000
+
+// stepper_ramp_update() can always stop within one ramp period from the slowest rate
+#if CONFIG_STEPPER_MIN_STEP_HZ * 1000 > CONFIG_STEPPER_MAX_ACCEL * CONFIG_STEPPER_RAMP_PERIOD_MS
+#error STEPPER_MIN_STEP_HZ must not exceed STEPPER_MAX_ACCEL * STEPPER_RAMP_PERIOD_MS / 1000
+#endif
+
+static gptimer_handle_t step_timer;
+static esp_timer_handle_t ramp_timer;
+static stepper_velocity_cb_t apply_cb;
+
+// Written by the ramp, picked up by the alarm ISR at the next falling edge. 0 stops.
+static volatile uint32_t next_half_ticks;
+static volatile bool running;   // set by the ramp on start, cleared by the ISR on stop
+
+// ISR only while the timer runs
+static uint32_t half_ticks;
+static uint32_t step_level;
+
+// Ramp state, esp_timer task only
+static float rate_hz;
+static bool forward = true;
+static bool driver_enabled;
+static int64_t seen_us;
+
+// Last command, any task. A 64-bit store is two 32-bit ones on Xtensa, so
+// target_lock keeps the ramp from seeing half of a new timestamp.
+static float target_hz;
+static int64_t target_us;
+static bool target_enable;
+static portMUX_TYPE target_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Runs from IRAM so pulses keep coming while flash writes have the cache off
+static bool IRAM_ATTR step_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *ctx)
+{
+    step_level ^= 1;
+    gpio_ll_set_level(&GPIO, STEPPER_STEP_PIN, step_level);
+
+    // Only change period once a pulse is complete, so no pulse is ever cut short
+    uint32_t next = next_half_ticks;
+    if (step_level == 0 && next != half_ticks) {
+        if (next == 0) {
+            gptimer_stop(timer);
+            running = false;
+        } else {
+            gptimer_alarm_config_t alarm = {
+                .alarm_count = next,
+                .reload_count = 0,
+                .flags.auto_reload_on_alarm = true,
+            };
+            gptimer_set_alarm_action(timer, &alarm);
+        }
+        half_ticks = next;
+    }
+    return false;
+}
+
+static void ramp(void *arg)
+{
+    const float max_delta = CONFIG_STEPPER_MAX_ACCEL * (CONFIG_STEPPER_RAMP_PERIOD_MS / 1000.0f);
+
+    portENTER_CRITICAL(&target_lock);
+    float requested_hz = target_hz;
+    int64_t requested_us = target_us;
+    bool enable = target_enable;
+    portEXIT_CRITICAL(&target_lock);
+
+    // EN goes up before the first pulse, with the motor at rest, so the ramp
+    // starts over from 0. Disabling is a ramp down to 0 like any other.
+    if (enable && !driver_enabled) {
+        stepper_enable(true);
+        driver_enabled = true;
+        rate_hz = 0.0f;
+    }
+    if (!enable) {
+        requested_hz = 0.0f;
+    }
+
+    // A reversal holds the rate at 0 until the ISR has stopped the timer
+    uint32_t ticks = stepper_ramp_update(&rate_hz, requested_hz, max_delta, running, forward,
+                                         CONFIG_STEPPER_MIN_STEP_HZ, TIMER_RESOLUTION_HZ);
+    next_half_ticks = ticks;
+
+    if (ticks > 0 && !running) {
+        forward = rate_hz > 0;
+        stepper_set_direction(forward);
+
+        half_ticks = ticks;
+        gptimer_alarm_config_t alarm = {
+            .alarm_count = ticks,
+            .reload_count = 0,
+            .flags.auto_reload_on_alarm = true,
+        };
+        gptimer_set_alarm_action(step_timer, &alarm);
+        gptimer_set_raw_count(step_timer, 0);
+        running = true;
+        gptimer_start(step_timer);
+    }
+
+    // Release the motor only once the ISR has stopped the timer after the last pulse
+    if (!enable && driver_enabled && rate_hz == 0.0f && !running) {
+        stepper_enable(false);
+        driver_enabled = false;
+    }
+
+    if (requested_us != seen_us) {
+        seen_us = requested_us;
+        if (apply_cb != NULL) {
+            apply_cb(requested_us, esp_timer_get_time());
+        }
+    }
+}
+
+void stepper_velocity_set_speed(float speed)
+{
+    float hz = stepper_speed_to_hz(speed, CONFIG_STEPPER_MAX_STEP_HZ);
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&target_lock);
+    target_hz = hz;
+    target_us = now;
+    portEXIT_CRITICAL(&target_lock);
+}
+
+void stepper_velocity_enable(bool enable)
+{
+    portENTER_CRITICAL(&target_lock);
+    target_enable = enable;
+    portEXIT_CRITICAL(&target_lock);
+}
+
+float stepper_velocity_hz(void)
+{
+    return rate_hz;
+}
+
+esp_err_t stepper_velocity_start(stepper_velocity_cb_t on_apply)
+{
+    apply_cb = on_apply;
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = TIMER_RESOLUTION_HZ,
+    };
+    esp_err_t err = gptimer_new_timer(&timer_config, &step_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = step_alarm,
+    };
+    err = gptimer_register_event_callbacks(step_timer, &cbs, NULL);
+    if (err == ESP_OK) {
+        err = gptimer_enable(step_timer);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    const esp_timer_create_args_t ramp_args = {
+        .callback = ramp,
+        .name = "stepper_ramp",
+    };
+    err = esp_timer_create(&ramp_args, &ramp_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return esp_timer_start_periodic(ramp_timer, CONFIG_STEPPER_RAMP_PERIOD_MS * 1000);
+}
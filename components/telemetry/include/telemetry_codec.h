@@ -0,0 +1,67 @@
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Compact packing for runs of sensor samples, used for SensorBatch.data.
+// Kept free of ESP-IDF headers so it builds anywhere; telemetry_codec.py
+// is the matching Python implementation.
+//
+// Each channel value is quantised to round(value / scale), then coded as
+// the difference from the same channel in the previous sample (the first
+// sample against 0), zigzag mapped and written as a varint. Channels are
+// interleaved: s0c0, s0c1, s1c0, s1c1, ...
+//
+// Slowly changing signals cost one byte per channel instead of the five a
+// protobuf float field takes.
+
+#define TELEMETRY_MAX_CHANNELS 4
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    uint32_t count;                         // samples encoded
+    uint8_t channels;
+    float inv_scale;
+    int32_t prev[TELEMETRY_MAX_CHANNELS];
+} telemetry_encoder_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t len;
+    size_t pos;
+    uint8_t channels;
+    float scale;
+    int32_t prev[TELEMETRY_MAX_CHANNELS];
+} telemetry_decoder_t;
+
+// Start a batch in buf. Returns false if channels or scale are out of range.
+bool telemetry_encoder_init(telemetry_encoder_t *enc, uint8_t *buf, size_t cap,
+                            uint8_t channels, float scale);
+
+// Append one sample of enc->channels values. Returns false, leaving the
+// batch as it was, if the sample does not fit; start a new batch then.
+bool telemetry_encode(telemetry_encoder_t *enc, const float *sample);
+
+bool telemetry_decoder_init(telemetry_decoder_t *dec, const uint8_t *buf, size_t len,
+                            uint8_t channels, float scale);
+
+// Read the next sample into sample. Returns false at the end of the data or
+// on a truncated/overlong varint.
+bool telemetry_decode(telemetry_decoder_t *dec, float *sample);
+
+// Zigzag maps signed to unsigned so small negative deltas stay short
+static inline uint32_t telemetry_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t telemetry_unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+#endif
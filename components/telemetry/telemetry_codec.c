@@ -0,0 +1,118 @@
+#include <math.h>
+#include "telemetry_codec.h"
+
+#define VARINT_MAX_LEN 5
+
+static int32_t quantise(float value, float inv_scale)
+{
+    float q = roundf(value * inv_scale);
+    if (isnan(q)) return 0;
+    if (q <= (float)INT32_MIN) return INT32_MIN;
+    if (q >= (float)INT32_MAX) return INT32_MAX;
+    return (int32_t)q;
+}
+
+static size_t put_varint(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool get_varint(telemetry_decoder_t *dec, uint32_t *v)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < VARINT_MAX_LEN; i++) {
+        if (dec->pos >= dec->len) {
+            return false;
+        }
+        uint8_t byte = dec->buf[dec->pos++];
+        result |= (uint32_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool telemetry_encoder_init(telemetry_encoder_t *enc, uint8_t *buf, size_t cap,
+                            uint8_t channels, float scale)
+{
+    if (channels == 0 || channels > TELEMETRY_MAX_CHANNELS || !(scale > 0.0f)) {
+        return false;
+    }
+
+    *enc = (telemetry_encoder_t){
+        .buf = buf,
+        .cap = cap,
+        .channels = channels,
+        .inv_scale = 1.0f / scale,
+    };
+    return true;
+}
+
+bool telemetry_encode(telemetry_encoder_t *enc, const float *sample)
+{
+    // Encode into scratch first so a sample that does not fit leaves no trace
+    uint8_t scratch[TELEMETRY_MAX_CHANNELS * VARINT_MAX_LEN];
+    int32_t q[TELEMETRY_MAX_CHANNELS];
+    size_t n = 0;
+
+    for (int c = 0; c < enc->channels; c++) {
+        q[c] = quantise(sample[c], enc->inv_scale);
+        // Wrapping subtraction; the decoder wraps back the same way
+        n += put_varint(scratch + n, telemetry_zigzag((int32_t)((uint32_t)q[c] - (uint32_t)enc->prev[c])));
+    }
+    if (enc->len + n > enc->cap) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        enc->buf[enc->len + i] = scratch[i];
+    }
+    enc->len += n;
+    for (int c = 0; c < enc->channels; c++) {
+        enc->prev[c] = q[c];
+    }
+    enc->count++;
+    return true;
+}
+
+bool telemetry_decoder_init(telemetry_decoder_t *dec, const uint8_t *buf, size_t len,
+                            uint8_t channels, float scale)
+{
+    if (channels == 0 || channels > TELEMETRY_MAX_CHANNELS || !(scale > 0.0f)) {
+        return false;
+    }
+
+    *dec = (telemetry_decoder_t){
+        .buf = buf,
+        .len = len,
+        .channels = channels,
+        .scale = scale,
+    };
+    return true;
+}
+
+bool telemetry_decode(telemetry_decoder_t *dec, float *sample)
+{
+    int32_t q[TELEMETRY_MAX_CHANNELS];
+    for (int c = 0; c < dec->channels; c++) {
+        uint32_t zz;
+        if (!get_varint(dec, &zz)) {
+            return false;
+        }
+        q[c] = (int32_t)((uint32_t)dec->prev[c] + (uint32_t)telemetry_unzigzag(zz));
+    }
+
+    for (int c = 0; c < dec->channels; c++) {
+        dec->prev[c] = q[c];
+        sample[c] = q[c] * dec->scale;
+    }
+    return true;
+}
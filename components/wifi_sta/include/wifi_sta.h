@@ -0,0 +1,12 @@
+#ifndef WIFI_STA_H
+#define WIFI_STA_H
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+// Join the access point from Kconfig and wait up to timeout for an IP.
+// Dropped connections are retried in the background. Expects NVS to be
+// initialised already.
+esp_err_t wifi_sta_connect(TickType_t timeout);
+
+#endif
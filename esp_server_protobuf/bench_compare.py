@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Collect the BENCH lines printed by a DECODE_BENCH=1 build, or by the host
+decode_bench target in host_test/, and compare them against a previous run.
+
+Usage:
+    python bench_compare.py <monitor_log> [baseline_log] [--threshold 10]
+
+Each BENCH line carries one JSON object. Decode results are keyed by
+message, mode and pbuf segment size; a result more than threshold percent
+slower than the baseline is reported as a regression and makes the script
+exit with 1. So do decode failures and malformed frames on which the buffer
+and pbuf receive paths disagree.
+"""
+
+import json
+import sys
+
+def load_results(path):
+    """Return {(msg, mode, segment): result} for decode results and
+    {path: result} for the malformed sweep"""
+    decode = {}
+    malformed = {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            idx = line.find("BENCH {")
+            if idx < 0:
+                continue
+            result = json.loads(line[idx + len("BENCH "):])
+            if result["bench"] == "decode":
+                decode[(result["msg"], result["mode"], result.get("segment", 0))] = result
+            elif result["bench"] == "malformed":
+                malformed[result.get("path", "buffer")] = result
+    return decode, malformed
+
+def main():
+    args = sys.argv[1:]
+    threshold = 10.0
+    if "--threshold" in args:
+        i = args.index("--threshold")
+        threshold = float(args[i + 1])
+        del args[i:i + 2]
+
+    if not args:
+        print(__doc__)
+        sys.exit(2)
+
+    current, malformed = load_results(args[0])
+    baseline = load_results(args[1])[0] if len(args) > 1 else {}
+
+    regressions = 0
+    print(f"{'message':<16}{'mode':<20}{'segment':>8}{'ns/msg':>10}{'baseline':>10}{'change':>9}")
+    for key in sorted(current):
+        result = current[key]
+        segment = key[2] or "-"
+        line = f"{key[0]:<16}{key[1]:<20}{segment:>8}{result['ns_per_msg']:>10}"
+        if key in baseline:
+            base = baseline[key]["ns_per_msg"]
+            change = (result["ns_per_msg"] - base) * 100.0 / base if base else 0.0
+            line += f"{base:>10}{change:>+8.1f}%"
+            if change > threshold:
+                line += "  REGRESSION"
+                regressions += 1
+        if result["failures"]:
+            line += f"  ({result['failures']} failures)"
+            regressions += 1
+        print(line)
+
+    for path, result in sorted(malformed.items()):
+        print(f"\nmalformed frames ({path}): {result['cases']} cases, {result['ok']} ok, "
+              f"{result['incomplete']} incomplete, {result['too_long']} too long, "
+              f"{result['decode_error']} decode errors", end="")
+        mismatches = result.get("mismatches", 0)
+        if mismatches:
+            print(f", {mismatches} cases where the receive paths disagree", end="")
+            regressions += 1
+        print()
+
+    sys.exit(1 if regressions else 0)
+
+if __name__ == "__main__":
+    main()
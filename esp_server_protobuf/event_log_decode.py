@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+Decode an event log dump into one line per record.
+
+The dump is either downloaded from the protobuf server
+(python test_client.py <ESP32_IP> log events.bin) or read straight off the
+partition (parttool.py read_partition --partition-name eventlog).
+
+Layout (see components/event_log/include/event_log_format.h): 4 KB sectors,
+each a 16-byte header followed by back-to-back records.
+
+Usage: python event_log_decode.py events.bin
+"""
+
+import struct
+import sys
+import zlib
+
+SECTOR_SIZE = 4096
+MAGIC = 0x474C5645
+
+SECTOR_HDR = struct.Struct('<IIHHI')  # magic, seq, boot, used, crc
+RECORD_HDR = struct.Struct('<BBI')    # type, len, time_ms
+
+EVENTS = {
+    1: ('ir', struct.Struct('<H'), ('count',)),
+    2: ('motor', struct.Struct('<iI'), ('steps', 'freq_hz')),
+    3: ('command', struct.Struct('<IffB'), ('id', 'speed', 'steering', 'enable')),
+}
+
+def read_sectors(data):
+    """Yield (seq, boot, records) for every intact sector, oldest first"""
+    sectors = {}
+    for base in range(0, len(data) - SECTOR_HDR.size + 1, SECTOR_SIZE):
+        magic, seq, boot, used, crc = SECTOR_HDR.unpack_from(data, base)
+        if magic != MAGIC or used > SECTOR_SIZE - SECTOR_HDR.size:
+            continue
+        records = data[base + SECTOR_HDR.size:base + SECTOR_HDR.size + used]
+        if len(records) != used or zlib.crc32(records) != crc:
+            print(f"# sector seq {seq}: bad CRC, skipped", file=sys.stderr)
+            continue
+        # The ring can move on mid-download, so the same sector may show up twice
+        sectors[seq] = (boot, records)
+
+    # Sequence numbers are consecutive on flash, so a gap is a sector lost
+    # to a torn download, a bad CRC or a failed write
+    prev = None
+    for seq in sorted(sectors):
+        if prev is not None and seq != prev + 1:
+            print(f"# sectors seq {prev + 1}..{seq - 1} missing", file=sys.stderr)
+        prev = seq
+        boot, records = sectors[seq]
+        yield seq, boot, records
+
+def decode_records(records):
+    """Yield (time_ms, name, fields) for each record in a sector"""
+    pos = 0
+    while pos + RECORD_HDR.size <= len(records):
+        event_type, length, time_ms = RECORD_HDR.unpack_from(records, pos)
+        payload = records[pos + RECORD_HDR.size:pos + RECORD_HDR.size + length]
+        pos += RECORD_HDR.size + length
+
+        if event_type in EVENTS and len(payload) == EVENTS[event_type][1].size:
+            name, layout, keys = EVENTS[event_type]
+            yield time_ms, name, dict(zip(keys, layout.unpack(payload)))
+        else:
+            yield time_ms, f"type{event_type}", {'raw': payload.hex()}
+
+def format_fields(fields):
+    return ' '.join(f"{k}={v:.3f}" if isinstance(v, float) else f"{k}={v}"
+                    for k, v in fields.items())
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__.strip())
+        sys.exit(1)
+
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+
+    count = 0
+    for seq, boot, records in read_sectors(data):
+        for time_ms, name, fields in decode_records(records):
+            print(f"boot {boot:<5} {time_ms / 1000:>10.3f} s  seq {seq:<6} {name:<8} {format_fields(fields)}")
+            count += 1
+
+    print(f"# {count} records", file=sys.stderr)
+
+if __name__ == "__main__":
+    main()
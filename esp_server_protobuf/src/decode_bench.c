@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <pb_decode.h>
+#include <pb_encode.h>
+#include "decode_bench.h"
+#include "frame.h"
+#include "pbuf_stream.h"
+
+#define TAG "BENCH"
+
+#define BENCH_ITERATIONS      10000
+#define BENCH_BATCH           32
+#define BENCH_MALFORMED_CASES 20000
+#define BENCH_MAX_SEGMENTS    128
+
+// Largest frame the samples produce: a ControlCommand inside an Envelope
+#define BENCH_FRAME_LEN (FRAME_HEADER_LEN + 2 + ControlCommand_size)
+
+// pbuf sizes for the streamed runs; the largest holds a whole sample frame
+static const size_t bench_segments[] = { 4, 16, 64 };
+
+// Envelope is sized for stats replies, so keep these off the caller's stack
+static Envelope bench_env;
+static Envelope bench_out;
+
+// Chains handed to pbuf_reader. They are laid out by hand rather than taken
+// from the lwIP pools, which hold far fewer pbufs than a 1-byte split needs.
+static struct pbuf bench_pbufs[BENCH_MAX_SEGMENTS];
+
+static int bench_failures;
+
+static void bench_report(const char *msg, const char *mode, int64_t elapsed_us, int messages, int failures)
+{
+    printf("BENCH {\"bench\":\"decode\",\"msg\":\"%s\",\"mode\":\"%s\",\"messages\":%d,"
+           "\"ns_per_msg\":%" PRId64 ",\"failures\":%d}\n",
+           msg, mode, messages, elapsed_us * 1000 / messages, failures);
+    bench_failures += failures;
+}
+
+static void bench_report_streamed(const char *msg, const char *mode, size_t segment,
+                                  int64_t elapsed_us, int messages, int failures)
+{
+    printf("BENCH {\"bench\":\"decode\",\"msg\":\"%s\",\"mode\":\"%s\",\"segment\":%u,"
+           "\"messages\":%d,\"ns_per_msg\":%" PRId64 ",\"failures\":%d}\n",
+           msg, mode, (unsigned)segment, messages, elapsed_us * 1000 / messages, failures);
+    bench_failures += failures;
+}
+
+// Point a chain of segment-byte pbufs at buf, as if it had been received in
+// pieces. Long inputs get larger segments so the chain fits bench_pbufs.
+static struct pbuf *bench_chain(const uint8_t *buf, size_t len, size_t segment)
+{
+    if (len == 0) {
+        return NULL;
+    }
+    if (segment == 0) {
+        segment = 1;
+    }
+    if ((len + segment - 1) / segment > BENCH_MAX_SEGMENTS) {
+        segment = (len + BENCH_MAX_SEGMENTS - 1) / BENCH_MAX_SEGMENTS;
+    }
+
+    struct pbuf *next = NULL;
+    size_t count = (len + segment - 1) / segment;
+    for (size_t i = count; i-- > 0;) {
+        struct pbuf *p = &bench_pbufs[i];
+        size_t off = i * segment;
+        memset(p, 0, sizeof(*p));
+        p->next = next;
+        p->payload = (void *)(buf + off);
+        p->len = (len - off) < segment ? (len - off) : segment;
+        p->tot_len = len - off;
+        next = p;
+    }
+    return next;
+}
+
+static void bench_sample(pb_size_t tag, uint32_t i, Envelope *env)
+{
+    memset(env, 0, sizeof(*env));
+    env->which_payload = tag;
+    if (tag == Envelope_control_tag) {
+        env->payload.control.id = 100000 + i;
+        env->payload.control.speed = 0.75f;
+        env->payload.control.steering = -0.25f;
+        env->payload.control.enable = true;
+    } else {
+        env->payload.sensor.temperature = 21.5f + (i % 10);
+        env->payload.sensor.humidity = 48.25f;
+    }
+}
+
+// Decode the bare message from a contiguous buffer
+static void bench_single(const char *name, pb_size_t tag)
+{
+    bench_sample(tag, 0, &bench_env);
+
+    const pb_msgdesc_t *fields = tag == Envelope_control_tag ? ControlCommand_fields : SensorData_fields;
+    uint8_t buf[BENCH_FRAME_LEN];
+    pb_ostream_t ostream = pb_ostream_from_buffer(buf, sizeof(buf));
+    if (!pb_encode(&ostream, fields, &bench_env.payload)) {
+        ESP_LOGE(TAG, "Encode failed: %s", PB_GET_ERROR(&ostream));
+        return;
+    }
+
+    int failures = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        pb_istream_t stream = pb_istream_from_buffer(buf, ostream.bytes_written);
+        if (!pb_decode(&stream, fields, &bench_out.payload)) failures++;
+    }
+    bench_report(name, "single", esp_timer_get_time() - start, BENCH_ITERATIONS, failures);
+}
+
+// Decode BENCH_BATCH frames laid out back to back in one receive buffer
+static void bench_batched(const char *name, pb_size_t tag)
+{
+    uint8_t buf[BENCH_BATCH * BENCH_FRAME_LEN];
+    size_t len = 0;
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        size_t written;
+        bench_sample(tag, i, &bench_env);
+        if (!frame_encode(&bench_env, buf + len, sizeof(buf) - len, &written)) {
+            ESP_LOGE(TAG, "Frame encode failed");
+            return;
+        }
+        len += written;
+    }
+
+    int failures = 0;
+    int rounds = BENCH_ITERATIONS / BENCH_BATCH;
+    int64_t start = esp_timer_get_time();
+    for (int r = 0; r < rounds; r++) {
+        size_t off = 0;
+        while (off < len) {
+            size_t consumed;
+            if (frame_decode(buf + off, len - off, &bench_out, &consumed) != FRAME_OK) {
+                failures++;
+                break;
+            }
+            off += consumed;
+        }
+    }
+    bench_report(name, "batched", esp_timer_get_time() - start, rounds * BENCH_BATCH, failures);
+}
+
+// Decode one frame split across pbufs, as received from the network, both by
+// copying it out first (the socket server) and by reading the chain in place
+// (the zero-copy server)
+static void bench_streamed(const char *name, pb_size_t tag)
+{
+    uint8_t frame[BENCH_FRAME_LEN];
+    size_t len;
+    bench_sample(tag, 0, &bench_env);
+    if (!frame_encode(&bench_env, frame, sizeof(frame), &len)) {
+        ESP_LOGE(TAG, "Frame encode failed");
+        return;
+    }
+
+    for (size_t s = 0; s < sizeof(bench_segments) / sizeof(bench_segments[0]); s++) {
+        size_t segment = bench_segments[s];
+        struct pbuf *chain = bench_chain(frame, len, segment);
+
+        int failures = 0;
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            uint8_t msg_buf[FRAME_HEADER_LEN + FRAME_MAX_LEN];
+            pbuf_copy_partial(chain, msg_buf, len, 0);
+
+            size_t consumed;
+            if (frame_decode(msg_buf, len, &bench_out, &consumed) != FRAME_OK) failures++;
+        }
+        bench_report_streamed(name, "streamed_copy", segment, esp_timer_get_time() - start,
+                              BENCH_ITERATIONS, failures);
+
+        failures = 0;
+        start = esp_timer_get_time();
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            pbuf_reader_t reader;
+            pbuf_reader_init_chain(&reader, chain);
+
+            pb_istream_t stream = pbuf_istream(&reader, 0);
+            if (frame_read(&stream, &bench_out) != FRAME_OK) failures++;
+        }
+        bench_report_streamed(name, "streamed_zero_copy", segment, esp_timer_get_time() - start,
+                              BENCH_ITERATIONS, failures);
+    }
+}
+
+bool decode_bench_compare_paths(const uint8_t *buf, size_t len, size_t segment,
+                                decode_bench_paths_t *result)
+{
+    pbuf_reader_t reader;
+    pbuf_reader_init_chain(&reader, bench_chain(buf, len, segment));
+
+    size_t off = 0;
+    result->frames = 0;
+    result->buffer = FRAME_OK;
+    result->pbuf = FRAME_OK;
+
+    while (true) {
+        // Both paths must run out of data at the same frame boundary
+        bool buffer_end = off == len;
+        bool pbuf_end = !pbuf_reader_wait(&reader);
+        if (buffer_end || pbuf_end) {
+            return buffer_end == pbuf_end;
+        }
+
+        // Decoded envelopes are compared bytewise, so start both from zero
+        size_t consumed;
+        memset(&bench_env, 0, sizeof(bench_env));
+        result->buffer = frame_decode(buf + off, len - off, &bench_env, &consumed);
+
+        memset(&bench_out, 0, sizeof(bench_out));
+        pb_istream_t stream = pbuf_istream(&reader, 0);
+        result->pbuf = frame_read(&stream, &bench_out);
+        if (result->pbuf == FRAME_DECODE_ERROR && reader.eof) {
+            result->pbuf = FRAME_INCOMPLETE;
+        }
+
+        if (result->buffer != FRAME_OK || result->pbuf != FRAME_OK) {
+            // A truncated frame may fail to decode before it runs out of
+            // bytes, so only a frame one path accepts is a disagreement
+            return result->buffer != FRAME_OK && result->pbuf != FRAME_OK;
+        }
+        if (memcmp(&bench_env, &bench_out, sizeof(bench_env)) != 0) {
+            return false;
+        }
+        result->frames++;
+        off += consumed;
+    }
+}
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void bench_report_malformed(const char *path, const int counts[], int mismatches, int64_t elapsed_us)
+{
+    printf("BENCH {\"bench\":\"malformed\",\"path\":\"%s\",\"cases\":%d,\"ok\":%d,"
+           "\"incomplete\":%d,\"too_long\":%d,\"decode_error\":%d,\"mismatches\":%d,"
+           "\"elapsed_us\":%" PRId64 "}\n",
+           path, BENCH_MALFORMED_CASES, counts[FRAME_OK], counts[FRAME_INCOMPLETE],
+           counts[FRAME_TOO_LONG], counts[FRAME_DECODE_ERROR], mismatches, elapsed_us);
+}
+
+// Corrupt, truncate and extend valid frames and run them through both receive
+// paths, split into pbufs of random size. Every case must come back with a
+// status, the same frames from both paths; anything else is a crash on-device
+// or a zero-copy bug.
+static void bench_malformed(void)
+{
+    uint8_t valid[2 * BENCH_FRAME_LEN];
+    size_t valid_len = 0;
+    for (pb_size_t tag = Envelope_sensor_tag; tag <= Envelope_control_tag; tag++) {
+        size_t written;
+        bench_sample(tag, tag, &bench_env);
+        if (!frame_encode(&bench_env, valid + valid_len, sizeof(valid) - valid_len, &written)) {
+            ESP_LOGE(TAG, "Frame encode failed");
+            return;
+        }
+        valid_len += written;
+    }
+
+    int buffer_counts[FRAME_DECODE_ERROR + 1] = {0};
+    int pbuf_counts[FRAME_DECODE_ERROR + 1] = {0};
+    int mismatches = 0;
+    uint32_t seed = 0x2545F491;
+    int64_t start = esp_timer_get_time();
+
+    for (int i = 0; i < BENCH_MALFORMED_CASES; i++) {
+        uint8_t buf[FRAME_HEADER_LEN + FRAME_MAX_LEN];
+        size_t len = valid_len;
+        memset(buf, 0, sizeof(buf));
+        memcpy(buf, valid, valid_len);
+
+        switch (xorshift32(&seed) % 3) {
+        case 0: // flip bits in a few bytes
+            for (int n = 1 + xorshift32(&seed) % 4; n > 0; n--) {
+                buf[xorshift32(&seed) % len] ^= 1 << (xorshift32(&seed) % 8);
+            }
+            break;
+        case 1: // truncate
+            len = xorshift32(&seed) % len;
+            break;
+        default: // overwrite a random span with random bytes
+            len = xorshift32(&seed) % sizeof(buf);
+            for (size_t off = xorshift32(&seed) % (len + 1); off < len; off++) {
+                buf[off] = xorshift32(&seed);
+            }
+            break;
+        }
+
+        decode_bench_paths_t result;
+        if (!decode_bench_compare_paths(buf, len, 1 + xorshift32(&seed) % 16, &result)) {
+            mismatches++;
+        }
+        buffer_counts[FRAME_OK] += result.frames;
+        pbuf_counts[FRAME_OK] += result.frames;
+        if (result.buffer != FRAME_OK) buffer_counts[result.buffer]++;
+        if (result.pbuf != FRAME_OK) pbuf_counts[result.pbuf]++;
+    }
+
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    bench_report_malformed("buffer", buffer_counts, mismatches, elapsed_us);
+    bench_report_malformed("pbuf", pbuf_counts, mismatches, elapsed_us);
+    bench_failures += mismatches;
+}
+
+int decode_bench_run(void)
+{
+    ESP_LOGI(TAG, "Running decode benchmark");
+    bench_failures = 0;
+
+    bench_single("ControlCommand", Envelope_control_tag);
+    bench_single("SensorData", Envelope_sensor_tag);
+    bench_batched("ControlCommand", Envelope_control_tag);
+    bench_batched("SensorData", Envelope_sensor_tag);
+    bench_streamed("ControlCommand", Envelope_control_tag);
+    bench_streamed("SensorData", Envelope_sensor_tag);
+    bench_malformed();
+    return bench_failures;
+}
@@ -0,0 +1,28 @@
+#ifndef DECODE_BENCH_H
+#define DECODE_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "frame.h"
+
+// Measure decode cost of the shipped schemas and feed mutated frames through
+// the framing parser. Each result is printed as one JSON object per line,
+// prefixed with "BENCH ", so runs can be collected and compared across commits.
+// Returns the number of failed decodes and receive-path mismatches.
+int decode_bench_run(void);
+
+typedef struct {
+    int frames;             // frames both paths decoded, and decoded alike
+    frame_status_t buffer;  // status frame_decode stopped with, FRAME_OK at end of data
+    frame_status_t pbuf;    // status frame_read stopped with, FRAME_OK at end of data
+} decode_bench_paths_t;
+
+// Decode buf as back-to-back frames through both receive paths: frame_decode
+// over the contiguous buffer, as the socket server does, and frame_read over
+// a chain of segment-byte pbufs, as the zero-copy server does. Returns false
+// if they disagree on any frame or on where decoding stops.
+bool decode_bench_compare_paths(const uint8_t *buf, size_t len, size_t segment,
+                                decode_bench_paths_t *result);
+
+#endif
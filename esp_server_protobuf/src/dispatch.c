@@ -0,0 +1,35 @@
+#include <stddef.h>
+#include "dispatch.h"
+
+typedef struct {
+    dispatch_handler_t handler;
+    void *ctx;
+} dispatch_entry_t;
+
+// Indexed directly by which_payload, which nanopb sets to the field tag
+static dispatch_entry_t dispatch_table[DISPATCH_MAX_TAG + 1];
+
+bool dispatch_register(pb_size_t tag, dispatch_handler_t handler, void *ctx)
+{
+    if (tag == 0 || tag > DISPATCH_MAX_TAG) {
+        return false;
+    }
+
+    dispatch_table[tag].handler = handler;
+    dispatch_table[tag].ctx = ctx;
+    return true;
+}
+
+dispatch_result_t dispatch_envelope(const Envelope *env, Envelope *reply)
+{
+    if (env->which_payload == 0 || env->which_payload > DISPATCH_MAX_TAG) {
+        return DISPATCH_UNHANDLED;
+    }
+
+    const dispatch_entry_t *entry = &dispatch_table[env->which_payload];
+    if (entry->handler == NULL) {
+        return DISPATCH_UNHANDLED;
+    }
+
+    return entry->handler(env, reply, entry->ctx) ? DISPATCH_REPLY : DISPATCH_DONE;
+}
@@ -0,0 +1,26 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stdbool.h>
+#include "envelope.pb.h"
+
+// Highest Envelope payload tag the dispatch table can hold
+#define DISPATCH_MAX_TAG 15
+
+typedef enum {
+    DISPATCH_UNHANDLED,     // empty envelope or no handler registered
+    DISPATCH_DONE,
+    DISPATCH_REPLY,         // handler filled in a reply to send back
+} dispatch_result_t;
+
+// Handlers return true after filling in reply, false if there is nothing to send back
+typedef bool (*dispatch_handler_t)(const Envelope *env, Envelope *reply, void *ctx);
+
+// Route payloads with the given oneof tag (Envelope_*_tag) to handler.
+// Returns false if the tag is out of range.
+bool dispatch_register(pb_size_t tag, dispatch_handler_t handler, void *ctx);
+
+// Call the handler registered for env->which_payload
+dispatch_result_t dispatch_envelope(const Envelope *env, Envelope *reply);
+
+#endif
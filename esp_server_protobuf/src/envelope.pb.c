@@ -0,0 +1,13 @@
+/* nanopb constant definitions for envelope.proto, written by hand
+ * in the layout of nanopb-0.4.9.1 output. No generator has been run on it:
+ * regenerate with nanopb_generator.py and compare before relying on it. */
+
+#include "envelope.pb.h"
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+PB_BIND(Envelope, Envelope, 2)
+
+
+
@@ -0,0 +1,81 @@
+/* nanopb header for envelope.proto, written by hand
+ * in the layout of nanopb-0.4.9.1 output. No generator has been run on it:
+ * regenerate with nanopb_generator.py and compare before relying on it. */
+
+#ifndef PB_ENVELOPE_PB_H_INCLUDED
+#define PB_ENVELOPE_PB_H_INCLUDED
+#include <pb.h>
+#include "control.pb.h"
+#include "log.pb.h"
+#include "sensor.pb.h"
+#include "stats.pb.h"
+
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+/* Struct definitions */
+typedef struct _Envelope {
+    pb_size_t which_payload;
+    union {
+        SensorData sensor;
+        ControlCommand control;
+        StatsRequest stats_request;
+        StatsResponse stats;
+        LogRequest log_request;
+        LogChunk log;
+        SensorBatch batch;
+    } payload;
+} Envelope;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initializer values for message structs */
+#define Envelope_init_default                    {0, {SensorData_init_default}}
+#define Envelope_init_zero                       {0, {SensorData_init_zero}}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define Envelope_sensor_tag                      1
+#define Envelope_control_tag                     2
+#define Envelope_stats_request_tag               3
+#define Envelope_stats_tag                       4
+#define Envelope_log_request_tag                 5
+#define Envelope_log_tag                         6
+#define Envelope_batch_tag                       7
+
+/* Struct field encoding specification for nanopb */
+#define Envelope_FIELDLIST(X, a) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,sensor,payload.sensor),   1) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,control,payload.control),   2) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,stats_request,payload.stats_request),   3) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,stats,payload.stats),   4) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,log_request,payload.log_request),   5) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,log,payload.log),   6) \
+X(a, STATIC,   ONEOF,    MESSAGE,  (payload,batch,payload.batch),   7)
+#define Envelope_CALLBACK NULL
+#define Envelope_DEFAULT NULL
+#define Envelope_payload_sensor_MSGTYPE SensorData
+#define Envelope_payload_control_MSGTYPE ControlCommand
+#define Envelope_payload_stats_request_MSGTYPE StatsRequest
+#define Envelope_payload_stats_MSGTYPE StatsResponse
+#define Envelope_payload_log_request_MSGTYPE LogRequest
+#define Envelope_payload_log_MSGTYPE LogChunk
+#define Envelope_payload_batch_MSGTYPE SensorBatch
+
+extern const pb_msgdesc_t Envelope_msg;
+
+/* Defines for backwards compatibility with code written before nanopb-0.4.0 */
+#define Envelope_fields &Envelope_msg
+
+/* Maximum encoded size of messages (where known) */
+#define ENVELOPE_PB_H_MAX_SIZE                   Envelope_size
+#define Envelope_size                            667
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,73 @@
+#include "frame.h"
+#include <pb_decode.h>
+#include <pb_encode.h>
+
+frame_status_t frame_header_parse(const uint8_t header[FRAME_HEADER_LEN], uint16_t *msg_len)
+{
+    *msg_len = (header[0] << 8) | header[1];
+    return *msg_len > FRAME_MAX_LEN ? FRAME_TOO_LONG : FRAME_OK;
+}
+
+frame_status_t frame_decode(const uint8_t *buf, size_t len, Envelope *env, size_t *consumed)
+{
+    if (len < FRAME_HEADER_LEN) {
+        return FRAME_INCOMPLETE;
+    }
+
+    uint16_t msg_len;
+    frame_status_t status = frame_header_parse(buf, &msg_len);
+    if (status != FRAME_OK) {
+        return status;
+    }
+    if (len - FRAME_HEADER_LEN < msg_len) {
+        return FRAME_INCOMPLETE;
+    }
+
+    pb_istream_t stream = pb_istream_from_buffer(buf + FRAME_HEADER_LEN, msg_len);
+    if (!pb_decode(&stream, Envelope_fields, env)) {
+        return FRAME_DECODE_ERROR;
+    }
+
+    *consumed = FRAME_HEADER_LEN + msg_len;
+    return FRAME_OK;
+}
+
+frame_status_t frame_read(pb_istream_t *stream, Envelope *env)
+{
+    uint8_t header[FRAME_HEADER_LEN];
+    uint16_t msg_len;
+
+    stream->bytes_left = sizeof(header);
+    if (!pb_read(stream, header, sizeof(header))) {
+        return FRAME_INCOMPLETE;
+    }
+
+    frame_status_t status = frame_header_parse(header, &msg_len);
+    if (status != FRAME_OK) {
+        return status;
+    }
+
+    // Stop the decode at the end of this frame
+    stream->bytes_left = msg_len;
+    if (!pb_decode(stream, Envelope_fields, env)) {
+        return FRAME_DECODE_ERROR;
+    }
+    return FRAME_OK;
+}
+
+bool frame_encode(const Envelope *env, uint8_t *buf, size_t size, size_t *written)
+{
+    if (size < FRAME_HEADER_LEN) {
+        return false;
+    }
+
+    pb_ostream_t stream = pb_ostream_from_buffer(buf + FRAME_HEADER_LEN, size - FRAME_HEADER_LEN);
+    if (!pb_encode(&stream, Envelope_fields, env) || stream.bytes_written > UINT16_MAX) {
+        return false;
+    }
+
+    buf[0] = stream.bytes_written >> 8;
+    buf[1] = stream.bytes_written & 0xFF;
+    *written = FRAME_HEADER_LEN + stream.bytes_written;
+    return true;
+}
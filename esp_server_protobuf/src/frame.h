@@ -0,0 +1,37 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "envelope.pb.h"
+
+// Wire framing on port 3333: 2-byte big-endian length, then an encoded Envelope.
+// FRAME_MAX_LEN bounds received frames; replies may be up to Envelope_size.
+#define FRAME_HEADER_LEN 2
+#define FRAME_MAX_LEN    256
+
+typedef enum {
+    FRAME_OK,
+    FRAME_INCOMPLETE,       // buffer ends before the frame does
+    FRAME_TOO_LONG,         // length header exceeds FRAME_MAX_LEN
+    FRAME_DECODE_ERROR,     // payload is not a valid Envelope
+} frame_status_t;
+
+// Validate a length header and return the payload length in msg_len
+frame_status_t frame_header_parse(const uint8_t header[FRAME_HEADER_LEN], uint16_t *msg_len);
+
+// Decode one frame from the start of buf. On FRAME_OK, consumed is set to
+// the number of bytes the frame occupied (header included).
+frame_status_t frame_decode(const uint8_t *buf, size_t len, Envelope *env, size_t *consumed);
+
+// Read one frame from stream, which must be positioned at a length header.
+// bytes_left is managed here, so the stream may run on past this frame, as
+// on the zero-copy receive path. A stream that runs dry mid-frame shows up
+// as FRAME_INCOMPLETE in the header and FRAME_DECODE_ERROR in the payload;
+// the caller tells the two apart from its own end-of-data state.
+frame_status_t frame_read(pb_istream_t *stream, Envelope *env);
+
+// Encode env as a frame into buf. Returns false if it does not fit.
+bool frame_encode(const Envelope *env, uint8_t *buf, size_t size, size_t *written);
+
+#endif
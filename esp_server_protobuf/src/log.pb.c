@@ -0,0 +1,16 @@
+/* nanopb constant definitions for log.proto and log.options, written by hand
+ * in the layout of nanopb-0.4.9.1 output. No generator has been run on it:
+ * regenerate with nanopb_generator.py and compare before relying on it. */
+
+#include "log.pb.h"
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+PB_BIND(LogRequest, LogRequest, AUTO)
+
+
+PB_BIND(LogChunk, LogChunk, 2)
+
+
+
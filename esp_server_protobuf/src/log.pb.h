@@ -0,0 +1,89 @@
+/* nanopb header for log.proto and log.options, written by hand
+ * in the layout of nanopb-0.4.9.1 output. No generator has been run on it:
+ * regenerate with nanopb_generator.py and compare before relying on it. */
+
+#ifndef PB_LOG_PB_H_INCLUDED
+#define PB_LOG_PB_H_INCLUDED
+#include <pb.h>
+
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+/* Struct definitions */
+/* Ask for the event log from offset; the server answers with a LogChunk.
+ With flush set, records still staged in RAM are written out first. That
+ uses up a flash sector, so a client polling the log leaves it unset. */
+typedef struct _LogRequest {
+    uint32_t offset;
+    bool flush;
+} LogRequest;
+
+typedef PB_BYTES_ARRAY_T(512) LogChunk_data_t;
+/* Raw log bytes from offset, oldest sector first. total is the log size
+ when the chunk was read; the download is done once offset reaches it.
+ dropped counts records lost since boot because the writer fell behind.
+ first_seq is the sequence number of the sector at offset 0. If it
+ changes between chunks the ring has moved on, the offsets no longer
+ line up, and the download has to start over. */
+typedef struct _LogChunk {
+    uint32_t offset;
+    uint32_t total;
+    LogChunk_data_t data;
+    uint32_t dropped;
+    uint32_t first_seq;
+} LogChunk;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initializer values for message structs */
+#define LogRequest_init_default                  {0, 0}
+#define LogChunk_init_default                    {0, 0, {0, {0}}, 0, 0}
+#define LogRequest_init_zero                     {0, 0}
+#define LogChunk_init_zero                       {0, 0, {0, {0}}, 0, 0}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define LogRequest_offset_tag                    1
+#define LogRequest_flush_tag                     2
+#define LogChunk_offset_tag                      1
+#define LogChunk_total_tag                       2
+#define LogChunk_data_tag                        3
+#define LogChunk_dropped_tag                     4
+#define LogChunk_first_seq_tag                   5
+
+/* Struct field encoding specification for nanopb */
+#define LogRequest_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, BOOL,     flush,             2)
+#define LogRequest_CALLBACK NULL
+#define LogRequest_DEFAULT NULL
+
+#define LogChunk_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   offset,            1) \
+X(a, STATIC,   SINGULAR, UINT32,   total,             2) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              3) \
+X(a, STATIC,   SINGULAR, UINT32,   dropped,           4) \
+X(a, STATIC,   SINGULAR, UINT32,   first_seq,         5)
+#define LogChunk_CALLBACK NULL
+#define LogChunk_DEFAULT NULL
+
+extern const pb_msgdesc_t LogRequest_msg;
+extern const pb_msgdesc_t LogChunk_msg;
+
+/* Defines for backwards compatibility with code written before nanopb-0.4.0 */
+#define LogRequest_fields &LogRequest_msg
+#define LogChunk_fields &LogChunk_msg
+
+/* Maximum encoded size of messages (where known) */
+#define LOG_PB_H_MAX_SIZE                        LogChunk_size
+#define LogChunk_size                            539
+#define LogRequest_size                          8
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -1,55 +1,274 @@
 #include <string.h>
 #include <inttypes.h>
+#include <math.h>
 #include <sys/socket.h>
-#include <esp_wifi.h>
-#include <esp_event.h>
 #include <nvs_flash.h>
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
-#include "control.pb.h"
+#include <esp_timer.h>
+#include "envelope.pb.h"
+#include "dispatch.h"
+#include "frame.h"
+#include "pbuf_stream.h"
+#include "decode_bench.h"
+#include "server_stats.h"
+#include "wifi_sta.h"
+#include "app_tasks.h"
+#include "event_log.h"
+#include "stepper.h"
+#include "telemetry_codec.h"
+#include "telemetry_bench.h"
 #include <pb_decode.h>
 
 #define TAG "PROTO"
 #define PORT 3333
 
-#ifndef WIFI_SSID
-#define WIFI_SSID  "Mangifera Indica"
-#define WIFI_PASS  "azbe50000"
+// Decode straight from lwIP pbufs via netconn instead of copying through a socket buffer
+#ifndef RX_ZERO_COPY
+#define RX_ZERO_COPY 1
 #endif
 
-static void wifi_init_sta(void)
+// Run the decode benchmark and malformed-frame sweep at startup
+#ifndef DECODE_BENCH
+#define DECODE_BENCH 0
+#endif
+
+// Compare SensorBatch against plain SensorData at startup
+#ifndef TELEMETRY_BENCH
+#define TELEMETRY_BENCH 0
+#endif
+
+// Drive the stepper's step rate from ControlCommand.speed through a hardware timer
+#ifndef VELOCITY_CONTROL
+#define VELOCITY_CONTROL 1
+#endif
+
+#define SERVER_STACK_SIZE 4096
+#define BATCH_CHANNELS    2     // SensorBatch channels: temperature, humidity
+#define WIFI_TIMEOUT_MS   10000
+
+// Commands stream at 100+ Hz, which would put ~2 KB/s of records on flash.
+// Only enable flips are logged at once; direction changes and speed moves of
+// at least COMMAND_LOG_SPEED_STEP are logged at most every COMMAND_LOG_MIN_MS.
+#define COMMAND_LOG_SPEED_STEP 0.1f
+#define COMMAND_LOG_MIN_MS     250
+
+// Envelope is sized for stats replies, so the server task keeps these off its stack
+static Envelope rx_env;
+static Envelope tx_env;
+static uint8_t tx_buf[FRAME_HEADER_LEN + Envelope_size];
+
+static bool command_worth_logging(const ControlCommand *cmd)
 {
-    // Initialize network interface
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
-
-    // Initialize WiFi
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
-
-    // Configure WiFi credentials
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = WIFI_SSID,
-            .password = WIFI_PASS,
-        },
-    };
+    static bool logged;
+    static bool last_enable;
+    static float last_speed;
+    static int64_t last_us;
 
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
-    ESP_ERROR_CHECK(esp_wifi_connect());
-    
-    ESP_LOGI(TAG, "WiFi connecting to %s...", WIFI_SSID);
+    int64_t now = esp_timer_get_time();
+    bool due = !logged || cmd->enable != last_enable;
+    if (!due && now - last_us >= COMMAND_LOG_MIN_MS * 1000) {
+        due = (cmd->speed < 0) != (last_speed < 0) ||
+              fabsf(cmd->speed - last_speed) >= COMMAND_LOG_SPEED_STEP;
+    }
+    if (!due) {
+        return false;
+    }
+
+    logged = true;
+    last_enable = cmd->enable;
+    last_speed = cmd->speed;
+    last_us = now;
+    return true;
+}
+
+static bool handle_control(const Envelope *env, Envelope *reply, void *ctx)
+{
+    const ControlCommand *cmd = &env->payload.control;
+#if VELOCITY_CONTROL
+    // Commands can arrive at 100+ Hz, faster than the UART can log them
+    ESP_LOGD(TAG, "Received - ID: %" PRIu32 ", Speed: %.2f, Steering: %.2f, Enable: %s",
+             cmd->id, cmd->speed, cmd->steering, cmd->enable ? "true" : "false");
+
+    // A single stepper has nothing to steer, so steering is only logged.
+    // Disabling ramps to a stop before EN drops; the speed is kept for re-enabling.
+    stepper_velocity_set_speed(cmd->speed);
+    stepper_velocity_enable(cmd->enable);
+#else
+    ESP_LOGI(TAG, "Received - ID: %" PRIu32 ", Speed: %.2f, Steering: %.2f, Enable: %s",
+             cmd->id, cmd->speed, cmd->steering, cmd->enable ? "true" : "false");
+#endif
+    if (command_worth_logging(cmd)) {
+        event_log_command(cmd->id, cmd->speed, cmd->steering, cmd->enable);
+    }
+    return false;
+}
+
+#if VELOCITY_CONTROL
+static void on_velocity_applied(int64_t requested_us, int64_t applied_us)
+{
+    stats_record(STATS_STAGE_ACTUATE, requested_us, applied_us);
+}
+#endif
+
+static bool handle_sensor(const Envelope *env, Envelope *reply, void *ctx)
+{
+    const SensorData *data = &env->payload.sensor;
+    ESP_LOGI(TAG, "Received - Temp: %.2f, Humidity: %.2f", data->temperature, data->humidity);
+    return false;
+}
+
+// A full batch has to fit in one received frame: oneof key, 2-byte length, message
+#if 3 + SensorBatch_size > FRAME_MAX_LEN
+#error SensorBatch.data max_size in sensor.options is too big for FRAME_MAX_LEN
+#endif
+
+static bool handle_batch(const Envelope *env, Envelope *reply, void *ctx)
+{
+    const SensorBatch *batch = &env->payload.batch;
+    telemetry_decoder_t dec;
+    if (!telemetry_decoder_init(&dec, batch->data.bytes, batch->data.size, BATCH_CHANNELS, batch->scale)) {
+        ESP_LOGW(TAG, "Batch has invalid scale %f", batch->scale);
+        return false;
+    }
+
+    float sample[BATCH_CHANNELS] = {0};
+    uint32_t count = 0;
+    while (telemetry_decode(&dec, sample)) {
+        count++;
+    }
+
+    if (count != batch->count || dec.pos != dec.len) {
+        ESP_LOGW(TAG, "Batch truncated: decoded %" PRIu32 " of %" PRIu32 " samples", count, batch->count);
+    }
+    ESP_LOGI(TAG, "Received %" PRIu32 " samples in %u bytes, last Temp: %.2f, Humidity: %.2f",
+             count, (unsigned)batch->data.size, sample[0], sample[1]);
+    return false;
+}
+
+static bool handle_stats_request(const Envelope *env, Envelope *reply, void *ctx)
+{
+    reply->which_payload = Envelope_stats_tag;
+    stats_fill(&reply->payload.stats);
+    return true;
+}
+
+// The client pages through the log one chunk per request until offset reaches total
+static bool handle_log_request(const Envelope *env, Envelope *reply, void *ctx)
+{
+    uint32_t offset = env->payload.log_request.offset;
+    if (env->payload.log_request.flush && event_log_flush() != ESP_OK) {
+        ESP_LOGW(TAG, "Event log flush failed, download starts from flash as is");
+    }
+
+    LogChunk *chunk = &reply->payload.log;
+    reply->which_payload = Envelope_log_tag;
+    chunk->offset = offset;
+    chunk->total = event_log_size(&chunk->first_seq);
+    chunk->data.size = 0;
+    chunk->dropped = event_log_dropped();
+
+    // first_seq is updated with the read, so it always matches the data
+    if (offset < chunk->total) {
+        size_t len = chunk->total - offset;
+        if (len > sizeof(chunk->data.bytes)) len = sizeof(chunk->data.bytes);
+        if (event_log_read(offset, chunk->data.bytes, len, &chunk->first_seq) == ESP_OK) {
+            chunk->data.size = len;
+        }
+    }
+    return true;
+}
+
+// Dispatch rx_env and record its stage latencies. Returns the length of the
+// encoded reply in tx_buf, or 0 if there is nothing to send back.
+static size_t handle_envelope(int64_t rx_us, int64_t decoded_us)
+{
+    dispatch_result_t result = dispatch_envelope(&rx_env, &tx_env);
+    int64_t done_us = esp_timer_get_time();
+
+    stats_record(STATS_STAGE_DECODE, rx_us, decoded_us);
+    stats_record(STATS_STAGE_DISPATCH, decoded_us, done_us);
+    stats_record(STATS_STAGE_FRAME, rx_us, done_us);
+
+    if (result == DISPATCH_UNHANDLED) {
+        ESP_LOGW(TAG, "No handler for payload %u", (unsigned)rx_env.which_payload);
+        return 0;
+    }
+
+    size_t len = 0;
+    if (result == DISPATCH_REPLY && !frame_encode(&tx_env, tx_buf, sizeof(tx_buf), &len)) {
+        ESP_LOGW(TAG, "Failed to encode reply");
+        return 0;
+    }
+    return len;
 }
 
+#if RX_ZERO_COPY
+static void server_task(void *arg)
+{
+    struct netconn *conn = netconn_new(NETCONN_TCP);
+    if (conn == NULL) {
+        ESP_LOGE(TAG, "Failed to create netconn");
+        vTaskDelete(NULL);
+        return;
+    }
+
+    err_t err = netconn_bind(conn, IP_ADDR_ANY, PORT);
+    if (err == ERR_OK) {
+        err = netconn_listen(conn);
+    }
+    if (err != ERR_OK) {
+        ESP_LOGE(TAG, "Failed to listen on port %d: %d", PORT, err);
+        netconn_delete(conn);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Server listening on port %d (zero-copy)", PORT);
+
+    while (true) {
+        struct netconn *client;
+        if (netconn_accept(conn, &client) != ERR_OK) continue;
+
+        pbuf_reader_t reader;
+        pbuf_reader_init_conn(&reader, client);
+
+        // Frames follow each other until the client closes the connection
+        while (pbuf_reader_wait(&reader)) {
+            // Time the frame from when the netbuf holding its first byte came in
+            int64_t rx_us = reader.rx_us;
+
+            // Decode the envelope directly from the received pbuf chain
+            pb_istream_t stream = pbuf_istream(&reader, 0);
+            frame_status_t status = frame_read(&stream, &rx_env);
+            if (status != FRAME_OK) {
+                if (reader.eof) {
+                    ESP_LOGW(TAG, "Connection closed mid-frame");
+                } else if (status == FRAME_DECODE_ERROR) {
+                    ESP_LOGW(TAG, "Failed to decode message: %s", PB_GET_ERROR(&stream));
+                } else if (status == FRAME_TOO_LONG) {
+                    ESP_LOGW(TAG, "Frame exceeds %d bytes", FRAME_MAX_LEN);
+                }
+                break;
+            }
+
+            size_t reply_len = handle_envelope(rx_us, esp_timer_get_time());
+            if (reply_len > 0 && netconn_write(client, tx_buf, reply_len, NETCONN_COPY) != ERR_OK) break;
+        }
+
+        pbuf_reader_release(&reader);
+        netconn_close(client);
+        netconn_delete(client);
+    }
+}
+#else
 static void server_task(void *arg)
 {
     int s = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
     if (s < 0) {
         ESP_LOGE(TAG, "Failed to create socket: %d", s);
+        vTaskDelete(NULL);
         return;
     }
     
@@ -63,6 +282,7 @@ static void server_task(void *arg)
     if (result < 0) {
         ESP_LOGE(TAG, "Failed to bind socket: %d", result);
         close(s);
+        vTaskDelete(NULL);
         return;
     }
     
@@ -70,6 +290,7 @@ static void server_task(void *arg)
     if (result < 0) {
         ESP_LOGE(TAG, "Failed to listen on socket: %d", result);
         close(s);
+        vTaskDelete(NULL);
         return;
     }
     
@@ -79,49 +300,81 @@ static void server_task(void *arg)
         int client = accept(s, NULL, NULL);
         if (client < 0) continue;
 
-        // Read message length (2 bytes)
-        uint8_t len_buf[2];
-        if (recv(client, len_buf, 2, MSG_WAITALL) != 2) {
-            close(client);
-            continue;
-        }
-        
-        uint16_t msg_len = (len_buf[0] << 8) | len_buf[1];
-        if (msg_len > 256) {
-            close(client);
-            continue;
-        }
+        // Frames follow each other until the client closes the connection
+        while (true) {
+            // Read message length (2 bytes)
+            uint8_t msg_buf[FRAME_HEADER_LEN + FRAME_MAX_LEN];
+            uint16_t msg_len;
+            if (recv(client, msg_buf, FRAME_HEADER_LEN, MSG_WAITALL) != FRAME_HEADER_LEN) break;
+            int64_t rx_us = esp_timer_get_time();
+            if (frame_header_parse(msg_buf, &msg_len) != FRAME_OK) break;
 
-        // Read protobuf message
-        uint8_t msg_buf[256];
-        if (recv(client, msg_buf, msg_len, MSG_WAITALL) != msg_len) {
-            close(client);
-            continue;
-        }
+            // Read protobuf message
+            if (recv(client, msg_buf + FRAME_HEADER_LEN, msg_len, MSG_WAITALL) != msg_len) break;
 
-        // Decode protobuf message
-        ControlCommand cmd = ControlCommand_init_default;
-        pb_istream_t stream = pb_istream_from_buffer(msg_buf, msg_len);
+            // Decode protobuf message
+            size_t consumed;
+            if (frame_decode(msg_buf, FRAME_HEADER_LEN + msg_len, &rx_env, &consumed) != FRAME_OK) {
+                ESP_LOGW(TAG, "Failed to decode message");
+                break;
+            }
 
-        if (pb_decode(&stream, ControlCommand_fields, &cmd)) {
-            ESP_LOGI(TAG, "Received - ID: %" PRIu32 ", Speed: %.2f, Steering: %.2f, Enable: %s",
-                     cmd.id, cmd.speed, cmd.steering, cmd.enable ? "true" : "false");
-        } else {
-            ESP_LOGW(TAG, "Failed to decode message: %s", PB_GET_ERROR(&stream));
+            size_t reply_len = handle_envelope(rx_us, esp_timer_get_time());
+            if (reply_len > 0 && send(client, tx_buf, reply_len, 0) != (ssize_t)reply_len) break;
         }
         
         close(client);
     }
 }
+#endif
+
+#if CONFIG_APP_STATIC_ALLOC
+static StackType_t server_stack[SERVER_STACK_SIZE];
+static StaticTask_t server_tcb;
+#endif
+
+static app_task_t app_tasks[] = {
+    { server_task, "server", SERVER_STACK_SIZE, 5, 0, APP_TASK_BUFFERS(server_stack, server_tcb) },
+};
 
 void app_main(void)
 {
     ESP_ERROR_CHECK(nvs_flash_init());
-    wifi_init_sta();
-    
-    // Wait for WiFi connection to be established
-    ESP_LOGI(TAG, "Waiting for WiFi connection...");
-    vTaskDelay(pdMS_TO_TICKS(5000)); // Wait 5 seconds
+    if (event_log_init() == ESP_OK) {
+        app_tasks_register("event_log", event_log_writer_task(), EVENT_LOG_WRITER_STACK_SIZE);
+        stats_register_task(event_log_writer_task());
+    } else {
+        ESP_LOGW(TAG, "Event log disabled");
+    }
+    if (wifi_sta_connect(pdMS_TO_TICKS(WIFI_TIMEOUT_MS)) != ESP_OK) {
+        ESP_LOGW(TAG, "No IP after %d ms, starting anyway", WIFI_TIMEOUT_MS);
+    }
+
+#if VELOCITY_CONTROL
+    ESP_ERROR_CHECK(stepper_init());
+    ESP_ERROR_CHECK(stepper_velocity_start(on_velocity_applied));
+#endif
+
+    dispatch_register(Envelope_sensor_tag, handle_sensor, NULL);
+    dispatch_register(Envelope_control_tag, handle_control, NULL);
+    dispatch_register(Envelope_stats_request_tag, handle_stats_request, NULL);
+    dispatch_register(Envelope_log_request_tag, handle_log_request, NULL);
+    dispatch_register(Envelope_batch_tag, handle_batch, NULL);
+
+    // lwIP's TCP/IP task sits on the receive path, so report its stack too
+    stats_register_task(xTaskGetHandle("tiT"));
+
+#if DECODE_BENCH
+    decode_bench_run();
+#endif
+#if TELEMETRY_BENCH
+    telemetry_bench_run();
+#endif
     
-    xTaskCreatePinnedToCore(server_task, "server", 4096, NULL, 5, NULL, 0);
+    app_tasks_start(app_tasks, APP_TASK_COUNT(app_tasks));
+    for (int i = 0; i < APP_TASK_COUNT(app_tasks); i++) {
+        stats_register_task(app_tasks[i].handle);
+    }
+    ESP_ERROR_CHECK(app_tasks_start_memory_report());
+    app_tasks_log_memory();
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+/* nanopb constant definitions for sensor.proto and sensor.options. Generated by
+ * nanopb-0.4.9.1, then extended by hand for SensorBatch; no generator has
+ * been run since. Regenerate with nanopb_generator.py and compare before
+ * relying on it. */
+
+#include "sensor.pb.h"
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+PB_BIND(SensorData, SensorData, AUTO)
+
+
+PB_BIND(SensorBatch, SensorBatch, AUTO)
+
+
+
@@ -0,0 +1,78 @@
+/* nanopb header for sensor.proto and sensor.options. Generated by
+ * nanopb-0.4.9.1, then extended by hand for SensorBatch; no generator has
+ * been run since. Regenerate with nanopb_generator.py and compare before
+ * relying on it. */
+
+#ifndef PB_SENSOR_PB_H_INCLUDED
+#define PB_SENSOR_PB_H_INCLUDED
+#include <pb.h>
+
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+/* Struct definitions */
+typedef struct _SensorData {
+    float temperature;
+    float humidity;
+} SensorData;
+
+typedef PB_BYTES_ARRAY_T(224) SensorBatch_data_t;
+/* A run of samples packed by telemetry_codec: quantised to multiples of
+ scale, delta coded per channel and written as zigzag varints.
+ Channels are temperature, humidity. */
+typedef struct _SensorBatch {
+    uint32_t count;
+    float scale;
+    SensorBatch_data_t data;
+} SensorBatch;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initializer values for message structs */
+#define SensorData_init_default                  {0, 0}
+#define SensorBatch_init_default                 {0, 0, {0, {0}}}
+#define SensorData_init_zero                     {0, 0}
+#define SensorBatch_init_zero                    {0, 0, {0, {0}}}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define SensorData_temperature_tag               1
+#define SensorData_humidity_tag                  2
+#define SensorBatch_count_tag                    1
+#define SensorBatch_scale_tag                    2
+#define SensorBatch_data_tag                     3
+
+/* Struct field encoding specification for nanopb */
+#define SensorData_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, FLOAT,    temperature,       1) \
+X(a, STATIC,   SINGULAR, FLOAT,    humidity,          2)
+#define SensorData_CALLBACK NULL
+#define SensorData_DEFAULT NULL
+
+#define SensorBatch_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             1) \
+X(a, STATIC,   SINGULAR, FLOAT,    scale,             2) \
+X(a, STATIC,   SINGULAR, BYTES,    data,              3)
+#define SensorBatch_CALLBACK NULL
+#define SensorBatch_DEFAULT NULL
+
+extern const pb_msgdesc_t SensorData_msg;
+extern const pb_msgdesc_t SensorBatch_msg;
+
+/* Defines for backwards compatibility with code written before nanopb-0.4.0 */
+#define SensorData_fields &SensorData_msg
+#define SensorBatch_fields &SensorBatch_msg
+
+/* Maximum encoded size of messages (where known) */
+#define SENSOR_PB_H_MAX_SIZE                     SensorBatch_size
+#define SensorBatch_size                         238
+#define SensorData_size                          10
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+#include <string.h>
+#include <esp_system.h>
+#include "server_stats.h"
+#include "latency_hist.h"
+
+#define STATS_MAX_TASKS ((int)(sizeof(((StatsResponse *)0)->tasks) / sizeof(TaskStack)))
+
+static const char *const stage_names[STATS_STAGE_COUNT] = {
+    [STATS_STAGE_DECODE]   = "decode",
+    [STATS_STAGE_DISPATCH] = "dispatch",
+    [STATS_STAGE_FRAME]    = "frame",
+    [STATS_STAGE_ACTUATE]  = "actuate",
+};
+
+static latency_hist_t stage_hists[STATS_STAGE_COUNT];
+static TaskHandle_t tasks[STATS_MAX_TASKS];
+static int task_count;
+
+void stats_record(stats_stage_t stage, int64_t start_us, int64_t end_us)
+{
+    int64_t us = end_us - start_us;
+    latency_hist_record(&stage_hists[stage], us < 0 ? 0 : us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+}
+
+void stats_register_task(TaskHandle_t task)
+{
+    if (task != NULL && task_count < STATS_MAX_TASKS) {
+        tasks[task_count++] = task;
+    }
+}
+
+void stats_fill(StatsResponse *resp)
+{
+    memset(resp, 0, sizeof(*resp));
+
+    for (int i = 0; i < STATS_STAGE_COUNT; i++) {
+        StageHistogram *out = &resp->stages[resp->stages_count++];
+        latency_hist_t snapshot;
+        latency_hist_snapshot(&stage_hists[i], &snapshot);
+
+        strlcpy(out->name, stage_names[i], sizeof(out->name));
+        out->buckets_count = LATENCY_HIST_BUCKETS;
+        memcpy(out->buckets, snapshot.buckets, sizeof(out->buckets));
+        out->count = snapshot.count;
+        out->max_us = snapshot.max_us;
+    }
+
+    for (int i = 0; i < task_count; i++) {
+        TaskStack *out = &resp->tasks[resp->tasks_count++];
+        strlcpy(out->name, pcTaskGetName(tasks[i]), sizeof(out->name));
+        out->high_water = uxTaskGetStackHighWaterMark(tasks[i]);
+    }
+
+    resp->free_heap = esp_get_free_heap_size();
+    resp->min_free_heap = esp_get_minimum_free_heap_size();
+}
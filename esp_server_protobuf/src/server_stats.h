@@ -0,0 +1,28 @@
+#ifndef SERVER_STATS_H
+#define SERVER_STATS_H
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "stats.pb.h"
+
+// Pipeline stages timed by the server task, from the packet holding the
+// start of a frame being received to the payload handler returning
+typedef enum {
+    STATS_STAGE_DECODE,     // packet received -> envelope decoded
+    STATS_STAGE_DISPATCH,   // envelope decoded -> handler done (actuated)
+    STATS_STAGE_FRAME,      // packet received -> handler done
+    STATS_STAGE_ACTUATE,    // speed command handled -> step timer picks it up
+    STATS_STAGE_COUNT
+} stats_stage_t;
+
+// Record one sample for stage. Each stage must only be recorded from one task.
+void stats_record(stats_stage_t stage, int64_t start_us, int64_t end_us);
+
+// Include task's stack high-water mark in stats responses
+void stats_register_task(TaskHandle_t task);
+
+// Fill resp with the stage histograms, task stacks and heap usage
+void stats_fill(StatsResponse *resp);
+
+#endif
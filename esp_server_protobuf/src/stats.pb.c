@@ -0,0 +1,22 @@
+/* nanopb constant definitions for stats.proto and stats.options, written by hand
+ * in the layout of nanopb-0.4.9.1 output. No generator has been run on it:
+ * regenerate with nanopb_generator.py and compare before relying on it. */
+
+#include "stats.pb.h"
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+PB_BIND(StatsRequest, StatsRequest, AUTO)
+
+
+PB_BIND(StageHistogram, StageHistogram, AUTO)
+
+
+PB_BIND(TaskStack, TaskStack, AUTO)
+
+
+PB_BIND(StatsResponse, StatsResponse, 2)
+
+
+
@@ -0,0 +1,122 @@
+/* nanopb header for stats.proto and stats.options, written by hand
+ * in the layout of nanopb-0.4.9.1 output. No generator has been run on it:
+ * regenerate with nanopb_generator.py and compare before relying on it. */
+
+#ifndef PB_STATS_PB_H_INCLUDED
+#define PB_STATS_PB_H_INCLUDED
+#include <pb.h>
+
+#if PB_PROTO_HEADER_VERSION != 40
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+/* Struct definitions */
+/* Empty request; the server answers with a StatsResponse */
+typedef struct _StatsRequest {
+    char dummy_field;
+} StatsRequest;
+
+/* Log2 latency histogram for one pipeline stage.
+ Bucket 0 counts 0 us, bucket i counts [2^(i-1), 2^i) us. */
+typedef struct _StageHistogram {
+    char name[16];
+    pb_size_t buckets_count;
+    uint32_t buckets[16];
+    uint32_t count;
+    uint32_t max_us;
+} StageHistogram;
+
+typedef struct _TaskStack {
+    char name[16];
+    uint32_t high_water; /* minimum free stack seen, in bytes */
+} TaskStack;
+
+typedef struct _StatsResponse {
+    pb_size_t stages_count;
+    StageHistogram stages[4];
+    pb_size_t tasks_count;
+    TaskStack tasks[8];
+    uint32_t free_heap;
+    uint32_t min_free_heap;
+} StatsResponse;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initializer values for message structs */
+#define StatsRequest_init_default                {0}
+#define StageHistogram_init_default              {"", 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0}
+#define TaskStack_init_default                   {"", 0}
+#define StatsResponse_init_default               {0, {StageHistogram_init_default, StageHistogram_init_default, StageHistogram_init_default, StageHistogram_init_default}, 0, {TaskStack_init_default, TaskStack_init_default, TaskStack_init_default, TaskStack_init_default, TaskStack_init_default, TaskStack_init_default, TaskStack_init_default, TaskStack_init_default}, 0, 0}
+#define StatsRequest_init_zero                   {0}
+#define StageHistogram_init_zero                 {"", 0, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, 0, 0}
+#define TaskStack_init_zero                      {"", 0}
+#define StatsResponse_init_zero                  {0, {StageHistogram_init_zero, StageHistogram_init_zero, StageHistogram_init_zero, StageHistogram_init_zero}, 0, {TaskStack_init_zero, TaskStack_init_zero, TaskStack_init_zero, TaskStack_init_zero, TaskStack_init_zero, TaskStack_init_zero, TaskStack_init_zero, TaskStack_init_zero}, 0, 0}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define StageHistogram_name_tag                  1
+#define StageHistogram_buckets_tag               2
+#define StageHistogram_count_tag                 3
+#define StageHistogram_max_us_tag                4
+#define TaskStack_name_tag                       1
+#define TaskStack_high_water_tag                 2
+#define StatsResponse_stages_tag                 1
+#define StatsResponse_tasks_tag                  2
+#define StatsResponse_free_heap_tag              3
+#define StatsResponse_min_free_heap_tag          4
+
+/* Struct field encoding specification for nanopb */
+#define StatsRequest_FIELDLIST(X, a) \
+
+#define StatsRequest_CALLBACK NULL
+#define StatsRequest_DEFAULT NULL
+
+#define StageHistogram_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   REPEATED, UINT32,   buckets,           2) \
+X(a, STATIC,   SINGULAR, UINT32,   count,             3) \
+X(a, STATIC,   SINGULAR, UINT32,   max_us,            4)
+#define StageHistogram_CALLBACK NULL
+#define StageHistogram_DEFAULT NULL
+
+#define TaskStack_FIELDLIST(X, a) \
+X(a, STATIC,   SINGULAR, STRING,   name,              1) \
+X(a, STATIC,   SINGULAR, UINT32,   high_water,        2)
+#define TaskStack_CALLBACK NULL
+#define TaskStack_DEFAULT NULL
+
+#define StatsResponse_FIELDLIST(X, a) \
+X(a, STATIC,   REPEATED, MESSAGE,  stages,            1) \
+X(a, STATIC,   REPEATED, MESSAGE,  tasks,             2) \
+X(a, STATIC,   SINGULAR, UINT32,   free_heap,         3) \
+X(a, STATIC,   SINGULAR, UINT32,   min_free_heap,     4)
+#define StatsResponse_CALLBACK NULL
+#define StatsResponse_DEFAULT NULL
+#define StatsResponse_stages_MSGTYPE StageHistogram
+#define StatsResponse_tasks_MSGTYPE TaskStack
+
+extern const pb_msgdesc_t StatsRequest_msg;
+extern const pb_msgdesc_t StageHistogram_msg;
+extern const pb_msgdesc_t TaskStack_msg;
+extern const pb_msgdesc_t StatsResponse_msg;
+
+/* Defines for backwards compatibility with code written before nanopb-0.4.0 */
+#define StatsRequest_fields &StatsRequest_msg
+#define StageHistogram_fields &StageHistogram_msg
+#define TaskStack_fields &TaskStack_msg
+#define StatsResponse_fields &StatsResponse_msg
+
+/* Maximum encoded size of messages (where known) */
+#define STATS_PB_H_MAX_SIZE                      StatsResponse_size
+#define StageHistogram_size                      111
+#define StatsRequest_size                        0
+#define StatsResponse_size                       664
+#define TaskStack_size                           23
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
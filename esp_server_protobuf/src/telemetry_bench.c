@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <pb_encode.h>
+#include <pb_decode.h>
+#include "sensor.pb.h"
+#include "telemetry_codec.h"
+#include "telemetry_bench.h"
+
+#define TAG "BENCH"
+
+#define BENCH_SAMPLES     512
+#define BENCH_ROUNDS      20
+#define BENCH_MAX_BATCHES 8
+#define BENCH_CHANNELS    2
+
+static float samples[BENCH_SAMPLES][BENCH_CHANNELS];
+static float decoded[BENCH_SAMPLES][BENCH_CHANNELS];
+
+// Encoded messages, kept so decode is timed on its own
+static uint8_t data_msgs[BENCH_SAMPLES][SensorData_size];
+static size_t data_lens[BENCH_SAMPLES];
+static uint8_t batch_msgs[BENCH_MAX_BATCHES][SensorBatch_size];
+static size_t batch_lens[BENCH_MAX_BATCHES];
+
+// SensorBatch carries its whole data buffer, so keep it off the caller's stack
+static SensorBatch batch;
+
+static int bench_failures;
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Slowly drifting temperature and humidity with a little ADC-style noise
+static void bench_fill(void)
+{
+    uint32_t seed = 0x2545F491;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        float noise = (xorshift32(&seed) % 1000) / 1000.0f - 0.5f;
+        samples[i][0] = 21.5f + 2.0f * sinf(i * 0.01f) + 0.05f * noise;
+        samples[i][1] = 48.0f + 5.0f * sinf(i * 0.003f) + 0.1f * noise;
+    }
+}
+
+static float bench_max_error(void)
+{
+    float max_err = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        for (int c = 0; c < BENCH_CHANNELS; c++) {
+            float err = fabsf(decoded[i][c] - samples[i][c]);
+            if (err > max_err) max_err = err;
+        }
+    }
+    return max_err;
+}
+
+static void bench_report(const char *format, float scale, size_t bytes, int64_t encode_us,
+                         int64_t decode_us, int failures)
+{
+    int n = BENCH_SAMPLES * BENCH_ROUNDS;
+    printf("BENCH {\"bench\":\"telemetry\",\"format\":\"%s\",\"scale\":%g,\"samples\":%d,"
+           "\"bytes_per_sample\":%.2f,\"encode_ns_per_sample\":%" PRId64 ","
+           "\"decode_ns_per_sample\":%" PRId64 ",\"max_error\":%g,\"failures\":%d}\n",
+           format, scale, BENCH_SAMPLES, (double)bytes / BENCH_SAMPLES, encode_us * 1000 / n,
+           decode_us * 1000 / n, bench_max_error(), failures);
+    bench_failures += failures;
+}
+
+// One SensorData message per sample, as client.py sends them
+static void bench_sensor_data(void)
+{
+    size_t bytes = 0;
+    int failures = 0;
+
+    int64_t start = esp_timer_get_time();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        bytes = 0;
+        for (int i = 0; i < BENCH_SAMPLES; i++) {
+            SensorData data = { samples[i][0], samples[i][1] };
+            pb_ostream_t stream = pb_ostream_from_buffer(data_msgs[i], SensorData_size);
+            if (!pb_encode(&stream, SensorData_fields, &data)) failures++;
+            data_lens[i] = stream.bytes_written;
+            bytes += stream.bytes_written;
+        }
+    }
+    int64_t encode_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_SAMPLES; i++) {
+            SensorData data = SensorData_init_zero;
+            pb_istream_t stream = pb_istream_from_buffer(data_msgs[i], data_lens[i]);
+            if (!pb_decode(&stream, SensorData_fields, &data)) failures++;
+            decoded[i][0] = data.temperature;
+            decoded[i][1] = data.humidity;
+        }
+    }
+    int64_t decode_us = esp_timer_get_time() - start;
+
+    bench_report("SensorData", 0, bytes, encode_us, decode_us, failures);
+}
+
+// Pack the run into as many full SensorBatch messages as it takes.
+// Returns the number of batches, or -1 if they did not fit.
+static int bench_batch_encode(float scale, size_t *bytes)
+{
+    int batches = 0;
+    int i = 0;
+    *bytes = 0;
+
+    while (i < BENCH_SAMPLES) {
+        telemetry_encoder_t enc;
+        if (batches == BENCH_MAX_BATCHES ||
+            !telemetry_encoder_init(&enc, batch.data.bytes, sizeof(batch.data.bytes), BENCH_CHANNELS, scale)) {
+            return -1;
+        }
+        while (i < BENCH_SAMPLES && telemetry_encode(&enc, samples[i])) {
+            i++;
+        }
+        if (enc.count == 0) return -1;
+
+        batch.count = enc.count;
+        batch.scale = scale;
+        batch.data.size = enc.len;
+
+        pb_ostream_t stream = pb_ostream_from_buffer(batch_msgs[batches], SensorBatch_size);
+        if (!pb_encode(&stream, SensorBatch_fields, &batch)) return -1;
+        batch_lens[batches++] = stream.bytes_written;
+        *bytes += stream.bytes_written;
+    }
+    return batches;
+}
+
+static void bench_batch(float scale)
+{
+    size_t bytes = 0;
+    int batches = 0;
+    int failures = 0;
+
+    int64_t start = esp_timer_get_time();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        batches = bench_batch_encode(scale, &bytes);
+    }
+    int64_t encode_us = esp_timer_get_time() - start;
+
+    if (batches < 0) {
+        ESP_LOGE(TAG, "Samples at scale %g need more than %d batches", scale, BENCH_MAX_BATCHES);
+        bench_failures++;
+        return;
+    }
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        int i = 0;
+        for (int b = 0; b < batches; b++) {
+            pb_istream_t stream = pb_istream_from_buffer(batch_msgs[b], batch_lens[b]);
+            telemetry_decoder_t dec;
+            if (!pb_decode(&stream, SensorBatch_fields, &batch) ||
+                !telemetry_decoder_init(&dec, batch.data.bytes, batch.data.size, BENCH_CHANNELS, batch.scale)) {
+                failures++;
+                continue;
+            }
+            int first = i;
+            while (i < BENCH_SAMPLES && telemetry_decode(&dec, decoded[i])) {
+                i++;
+            }
+            if ((uint32_t)(i - first) != batch.count) failures++;
+        }
+    }
+    int64_t decode_us = esp_timer_get_time() - start;
+
+    bench_report("SensorBatch", scale, bytes, encode_us, decode_us, failures);
+}
+
+int telemetry_bench_run(void)
+{
+    ESP_LOGI(TAG, "Running telemetry benchmark, %d samples", BENCH_SAMPLES);
+
+    bench_fill();
+    bench_sensor_data();
+    bench_batch(0.01f);
+    bench_batch(0.001f);
+    return bench_failures;
+}
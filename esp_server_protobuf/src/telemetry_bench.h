@@ -0,0 +1,10 @@
+#ifndef TELEMETRY_BENCH_H
+#define TELEMETRY_BENCH_H
+
+// Encode and decode the same sample run as one SensorData message per sample
+// and as SensorBatch messages at a few scales. Each result is printed as one
+// JSON object per line, prefixed with "BENCH ", like decode_bench.
+// Returns the number of failed encodes and decodes.
+int telemetry_bench_run(void);
+
+#endif
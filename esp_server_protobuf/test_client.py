@@ -1,9 +1,11 @@
 #!/usr/bin/env python3
 """
 Python client to test the ESP32 protobuf server.
-Sends ControlCommand messages to the ESP32 over TCP.
+Sends ControlCommand and SensorData messages to the ESP32 over TCP,
+each wrapped in an Envelope and prefixed with a 2-byte length.
 """
 
+import math
 import socket
 import struct
 import time
@@ -49,13 +51,96 @@ class ControlCommand:
         return bytes(data)
     
     def _encode_varint(self, value):
-        """Encode a varint (variable-length integer)"""
-        result = bytearray()
-        while value >= 0x80:
-            result.append((value & 0x7F) | 0x80)
-            value >>= 7
-        result.append(value & 0x7F)
-        return result
+        return encode_varint(value)
+
+class SensorData:
+    def __init__(self, temperature=0.0, humidity=0.0):
+        self.temperature = temperature
+        self.humidity = humidity
+
+    def serialize(self):
+        data = bytearray()
+
+        # Field 1: temperature (tag=1, fixed32)
+        data.extend(encode_varint(1 << 3 | 5))
+        data.extend(struct.pack('<f', self.temperature))
+
+        # Field 2: humidity (tag=2, fixed32)
+        data.extend(encode_varint(2 << 3 | 5))
+        data.extend(struct.pack('<f', self.humidity))
+
+        return bytes(data)
+
+# Envelope oneof tags (see envelope.proto)
+ENVELOPE_SENSOR = 1
+ENVELOPE_CONTROL = 2
+ENVELOPE_STATS_REQUEST = 3
+ENVELOPE_STATS = 4
+ENVELOPE_LOG_REQUEST = 5
+ENVELOPE_LOG = 6
+ENVELOPE_BATCH = 7
+
+def encode_varint(value):
+    """Encode a varint (variable-length integer)"""
+    result = bytearray()
+    while value >= 0x80:
+        result.append((value & 0x7F) | 0x80)
+        value >>= 7
+    result.append(value & 0x7F)
+    return result
+
+def decode_varint(data, pos):
+    """Decode a varint at pos, returning (value, new_pos)"""
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+def decode_fields(data):
+    """Split an encoded message into a list of (field, value) pairs"""
+    fields = []
+    pos = 0
+    while pos < len(data):
+        key, pos = decode_varint(data, pos)
+        field, wire_type = key >> 3, key & 7
+        if wire_type == 0:
+            value, pos = decode_varint(data, pos)
+        elif wire_type == 2:
+            length, pos = decode_varint(data, pos)
+            value = data[pos:pos + length]
+            pos += length
+        elif wire_type == 5:
+            value = data[pos:pos + 4]
+            pos += 4
+        else:
+            raise ValueError(f"unsupported wire type {wire_type}")
+        fields.append((field, value))
+    return fields
+
+def decode_packed(data):
+    values = []
+    pos = 0
+    while pos < len(data):
+        value, pos = decode_varint(data, pos)
+        values.append(value)
+    return values
+
+def envelope_frame(message):
+    """Wrap a message in an Envelope and prepend the 2-byte big-endian length"""
+    tag = ENVELOPE_CONTROL if isinstance(message, ControlCommand) else ENVELOPE_SENSOR
+    payload = message.serialize()
+
+    envelope = bytearray()
+    envelope.extend(encode_varint(tag << 3 | 2))  # wire type 2 (length-delimited)
+    envelope.extend(encode_varint(len(payload)))
+    envelope.extend(payload)
+
+    return struct.pack('>H', len(envelope)) + bytes(envelope)
 
 def send_command(host, port, command):
     """Send a ControlCommand to the ESP32 server"""
@@ -69,19 +154,13 @@ def send_command(host, port, command):
         sock.connect((host, port))
         print("Connected!")
         
-        # Serialize the command
-        message_data = command.serialize()
-        message_length = len(message_data)
+        # Serialize the command into a length-prefixed Envelope
+        frame = envelope_frame(command)
         
-        print(f"Sending message (length: {message_length} bytes)")
+        print(f"Sending message (length: {len(frame) - 2} bytes)")
         print(f"Command: ID={command.id}, Speed={command.speed}, Steering={command.steering}, Enable={command.enable}")
         
-        # Send length header (2 bytes, big-endian)
-        length_header = struct.pack('>H', message_length)
-        sock.send(length_header)
-        
-        # Send the protobuf message
-        sock.send(message_data)
+        sock.sendall(frame)
         
         print("Message sent successfully!")
         
@@ -94,6 +173,153 @@ def send_command(host, port, command):
     finally:
         sock.close()
 
+def recv_exact(sock, count):
+    data = b''
+    while len(data) < count:
+        chunk = sock.recv(count - len(data))
+        if not chunk:
+            raise ConnectionError("connection closed")
+        data += chunk
+    return data
+
+def request_stats(host, port):
+    """Ask the server for its latency histograms and stack/heap usage"""
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.settimeout(5.0)
+        sock.connect((host, port))
+
+        request = bytes(encode_varint(ENVELOPE_STATS_REQUEST << 3 | 2)) + b'\x00'
+        sock.sendall(struct.pack('>H', len(request)) + request)
+
+        length = struct.unpack('>H', recv_exact(sock, 2))[0]
+        envelope = recv_exact(sock, length)
+
+    for field, stats in decode_fields(envelope):
+        if field != ENVELOPE_STATS:
+            continue
+        for field, value in decode_fields(stats):
+            if field == 1:
+                hist = dict(decode_fields(value))
+                buckets = decode_packed(hist.get(2, b''))
+                name = hist.get(1, b'').decode()
+                print(f"{name:<10} count={hist.get(3, 0)} max={hist.get(4, 0)} us")
+                for i, n in enumerate(buckets):
+                    if n:
+                        low = 0 if i == 0 else 1 << (i - 1)
+                        print(f"    >= {low:>6} us: {n}")
+            elif field == 2:
+                task = dict(decode_fields(value))
+                print(f"task {task.get(1, b'').decode():<16} stack high-water {task.get(2, 0)} bytes")
+            elif field == 3:
+                print(f"free heap {value} bytes")
+            elif field == 4:
+                print(f"min free heap {value} bytes")
+
+def request_log_chunk(sock, offset, flush=False):
+    """Ask for the event log from offset and return the LogChunk fields.
+    With flush, the device first writes out the records staged in RAM."""
+    request = bytes(encode_varint(1 << 3 | 0) + encode_varint(offset)) if offset else b''
+    if flush:
+        request += bytes(encode_varint(2 << 3 | 0) + encode_varint(1))
+    envelope = bytes(encode_varint(ENVELOPE_LOG_REQUEST << 3 | 2) + encode_varint(len(request))) + bytes(request)
+    sock.sendall(struct.pack('>H', len(envelope)) + envelope)
+
+    length = struct.unpack('>H', recv_exact(sock, 2))[0]
+    return dict(decode_fields(dict(decode_fields(recv_exact(sock, length))).get(ENVELOPE_LOG, b'')))
+
+def download_log(host, port, path, attempts=5):
+    """Page through the event log one LogChunk at a time and save the raw bytes.
+
+    Offsets count from the oldest sector. Once the ring has wrapped, every
+    sector the device writes moves that on, which shows up as a new
+    first_seq; the pages downloaded so far no longer line up and the
+    download starts over. The size from the first chunk bounds the download,
+    so a log that keeps growing does not keep it going."""
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.settimeout(5.0)
+        sock.connect((host, port))
+
+        # Flush once so the download includes the latest records; a retry
+        # only needs the log to hold still
+        for attempt in range(attempts):
+            data = bytearray()
+            chunk = request_log_chunk(sock, 0, flush=attempt == 0)
+            total, first_seq = chunk.get(2, 0), chunk.get(5, 0)
+            while chunk.get(5, 0) == first_seq and chunk.get(3):
+                data.extend(chunk[3])
+                if len(data) >= total:
+                    break
+                chunk = request_log_chunk(sock, len(data))
+            dropped = chunk.get(4, 0)
+
+            if chunk.get(5, 0) == first_seq:
+                break
+            print(f"Log moved on from sector seq {first_seq} to {chunk.get(5, 0)} "
+                  f"after {len(data)} bytes, restarting")
+        else:
+            print(f"Log kept moving on, giving up after {attempts} attempts")
+            return
+
+    with open(path, 'wb') as f:
+        f.write(data)
+    print(f"Saved {len(data)} of {total} bytes to {path}; decode with event_log_decode.py {path}")
+    if dropped:
+        print(f"{dropped} records were dropped since boot because the log writer fell behind")
+
+def drive(host, port, rate_hz, seconds):
+    """Stream speed commands at rate_hz, sweeping a sine, then show how fast the step timer kept up"""
+    count = int(rate_hz * seconds)
+    period = 1.0 / rate_hz
+    late = 0
+
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.settimeout(5.0)
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        sock.connect((host, port))
+
+        start = time.perf_counter()
+        for i in range(count):
+            speed = math.sin(2 * math.pi * 0.5 * i * period)  # 2 s sweep, full reverse each way
+            sock.sendall(envelope_frame(ControlCommand(id=i, speed=speed, enable=True)))
+
+            delay = start + (i + 1) * period - time.perf_counter()
+            if delay > 0:
+                time.sleep(delay)
+            else:
+                late += 1
+        elapsed = time.perf_counter() - start
+
+        sock.sendall(envelope_frame(ControlCommand(id=count, speed=0.0, enable=False)))
+
+    print(f"Sent {count} speed commands in {elapsed:.2f} s: {count / elapsed:.0f} Hz "
+          f"(target {rate_hz} Hz, {late} sent late)")
+    print("Speed command -> step timer latency is the 'actuate' stage below\n")
+    time.sleep(0.5)
+    request_stats(host, port)
+
+def send_burst(host, port, count):
+    """Send count alternating SensorData/ControlCommand frames on one connection"""
+    frames = []
+    for i in range(count):
+        if i % 2:
+            frames.append(envelope_frame(ControlCommand(id=i, speed=0.5, steering=-0.1, enable=True)))
+        else:
+            frames.append(envelope_frame(SensorData(temperature=20.0 + i % 10, humidity=50.0)))
+    payload = b''.join(frames)
+
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.settimeout(5.0)
+        sock.connect((host, port))
+
+        start = time.perf_counter()
+        sock.sendall(payload)
+        sock.shutdown(socket.SHUT_WR)
+        sock.recv(1)  # returns once the server has drained and closed
+        elapsed = time.perf_counter() - start
+
+    print(f"Sent {count} mixed frames ({len(payload)} bytes) in {elapsed:.3f} s: "
+          f"{count / elapsed:.0f} frames/s")
+
 def main():
     # Default ESP32 IP (you'll need to update this with your ESP32's actual IP)
     ESP32_IP = "10.16.1.17"  # Update this with your ESP32's IP address
@@ -101,6 +327,22 @@ def main():
     
     if len(sys.argv) > 1:
         ESP32_IP = sys.argv[1]
+
+    if len(sys.argv) > 3 and sys.argv[2] == "burst":
+        send_burst(ESP32_IP, ESP32_PORT, int(sys.argv[3]))
+        return
+
+    if len(sys.argv) > 2 and sys.argv[2] == "stats":
+        request_stats(ESP32_IP, ESP32_PORT)
+        return
+
+    if len(sys.argv) > 4 and sys.argv[2] == "drive":
+        drive(ESP32_IP, ESP32_PORT, float(sys.argv[3]), float(sys.argv[4]))
+        return
+
+    if len(sys.argv) > 3 and sys.argv[2] == "log":
+        download_log(ESP32_IP, ESP32_PORT, sys.argv[3])
+        return
     
     print("ESP32 Protobuf Client Test")
     print("=" * 30)
@@ -122,6 +364,10 @@ def main():
     
     print("\nAll tests completed!")
     print("\nTo use with custom IP: python test_client.py <ESP32_IP>")
+    print("For a mixed-traffic throughput run: python test_client.py <ESP32_IP> burst <N>")
+    print("For latency histograms and stack usage: python test_client.py <ESP32_IP> stats")
+    print("To download the event log: python test_client.py <ESP32_IP> log <file>")
+    print("To benchmark velocity control: python test_client.py <ESP32_IP> drive <HZ> <SECONDS>")
 
 if __name__ == "__main__":
     main()
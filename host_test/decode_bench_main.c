@@ -0,0 +1,8 @@
+#include "decode_bench.h"
+
+// The on-device DECODE_BENCH=1 run, on the host: single, batched and
+// streamed decode timings plus the malformed sweep over both receive paths
+int main(void)
+{
+    return decode_bench_run() == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#ifndef HOST_FAKE_DRIVER_GPIO_H
+#define HOST_FAKE_DRIVER_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// GPIO pins whose inputs the test drives. ISRs run on the driving thread,
+// when an edge or level matches the pin's interrupt type.
+
+typedef enum {
+    GPIO_NUM_NC = -1,
+    GPIO_NUM_MAX = 40,
+} gpio_num_t;
+
+typedef enum {
+    GPIO_MODE_DISABLE,
+    GPIO_MODE_INPUT,
+    GPIO_MODE_OUTPUT,
+    GPIO_MODE_INPUT_OUTPUT,
+} gpio_mode_t;
+
+typedef enum {
+    GPIO_PULLUP_DISABLE,
+    GPIO_PULLUP_ENABLE,
+} gpio_pullup_t;
+
+typedef enum {
+    GPIO_PULLDOWN_DISABLE,
+    GPIO_PULLDOWN_ENABLE,
+} gpio_pulldown_t;
+
+typedef enum {
+    GPIO_INTR_DISABLE,
+    GPIO_INTR_POSEDGE,
+    GPIO_INTR_NEGEDGE,
+    GPIO_INTR_ANYEDGE,
+    GPIO_INTR_LOW_LEVEL,
+    GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    gpio_mode_t mode;
+    gpio_pullup_t pull_up_en;
+    gpio_pulldown_t pull_down_en;
+    gpio_int_type_t intr_type;
+} gpio_config_t;
+
+typedef void (*gpio_isr_t)(void *arg);
+
+esp_err_t gpio_config(const gpio_config_t *cfg);
+int gpio_get_level(gpio_num_t pin);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level);
+
+// ESP_ERR_INVALID_STATE if the service is already installed, as on the chip
+esp_err_t gpio_install_isr_service(int flags);
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t isr, void *arg);
+
+// Test hooks: forget all pins and the ISR service, see how a pin was last
+// configured (NULL if never), drive an input from outside
+void fake_gpio_reset(void);
+const gpio_config_t *fake_gpio_config(gpio_num_t pin);
+void fake_gpio_drive(gpio_num_t pin, int level);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef HOST_FAKE_ESP_HEAP_CAPS_H
+#define HOST_FAKE_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed figures; the host heap has nothing comparable to report
+#define MALLOC_CAP_8BIT (1 << 2)
+
+static inline size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void)caps;
+    return 200 * 1024;
+}
+
+static inline size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    (void)caps;
+    return 180 * 1024;
+}
+
+static inline size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    (void)caps;
+    return 110 * 1024;
+}
+
+#endif
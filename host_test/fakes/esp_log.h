@@ -0,0 +1,12 @@
+#ifndef HOST_FAKE_ESP_LOG_H
+#define HOST_FAKE_ESP_LOG_H
+
+#include <stdio.h>
+
+// ESP-IDF logging on stderr, so BENCH lines on stdout stay machine-readable
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) fprintf(stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) do { (void)(tag); } while (0)
+
+#endif
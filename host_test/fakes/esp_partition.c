@@ -0,0 +1,73 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_partition.h"
+
+#define SECTOR_SIZE 4096
+
+static esp_partition_t partition;
+static uint8_t *data;
+static uint32_t erases;
+
+void fake_partition_create(const char *label, uint32_t size)
+{
+    free(data);
+    data = malloc(size);
+    memset(data, 0xff, size);
+    partition.label = label;
+    partition.size = size;
+    erases = 0;
+}
+
+uint8_t *fake_partition_data(void)
+{
+    return data;
+}
+
+uint32_t fake_partition_erase_count(void)
+{
+    return erases;
+}
+
+const esp_partition_t *esp_partition_find_first(int type, int subtype, const char *label)
+{
+    (void)type;
+    (void)subtype;
+    return data != NULL && strcmp(label, partition.label) == 0 ? &partition : NULL;
+}
+
+static bool in_range(const esp_partition_t *part, size_t offset, size_t size)
+{
+    return part == &partition && offset <= part->size && size <= part->size - offset;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size)
+{
+    if (!in_range(part, offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, data + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size)
+{
+    if (!in_range(part, offset, size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t *in = src;
+    for (size_t i = 0; i < size; i++) {
+        data[offset + i] &= in[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size)
+{
+    if (!in_range(part, offset, size) || offset % SECTOR_SIZE != 0 || size % SECTOR_SIZE != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(data + offset, 0xff, size);
+    erases += size / SECTOR_SIZE;
+    return ESP_OK;
+}
@@ -0,0 +1,28 @@
+#ifndef HOST_FAKE_ESP_PARTITION_H
+#define HOST_FAKE_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// One data partition held in RAM, with NOR flash rules: erase sets whole
+// sectors to 0xFF and writes can only clear bits
+#define ESP_PARTITION_TYPE_DATA      1
+#define ESP_PARTITION_SUBTYPE_ANY    0xff
+
+typedef struct {
+    const char *label;
+    uint32_t size;
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(int type, int subtype, const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *part, size_t offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *part, size_t offset, size_t size);
+
+// Test hooks: create the partition (erased), reach its bytes, count erases
+void fake_partition_create(const char *label, uint32_t size);
+uint8_t *fake_partition_data(void);
+uint32_t fake_partition_erase_count(void);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef HOST_FAKE_ESP_ROM_CRC_H
+#define HOST_FAKE_ESP_ROM_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The ROM's little-endian CRC-32, the same as zlib.crc32 in the decoders
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+#endif
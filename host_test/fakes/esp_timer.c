@@ -0,0 +1,74 @@
+#include <string.h>
+#include <time.h>
+#include "esp_timer.h"
+
+#define MAX_TIMERS 8
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+    uint64_t period_us;
+};
+
+static struct esp_timer timers[MAX_TIMERS];
+static int timer_count;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out)
+{
+    if (args == NULL || args->callback == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer_count == MAX_TIMERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    timers[timer_count].args = *args;
+    *out = &timers[timer_count++];
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    if (timer == NULL || period_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->period_us != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->period_us = period_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL || timer->period_us == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->period_us = 0;
+    return ESP_OK;
+}
+
+esp_timer_handle_t fake_esp_timer_find(const char *name)
+{
+    for (int i = 0; i < timer_count; i++) {
+        if (timers[i].args.name != NULL && strcmp(timers[i].args.name, name) == 0) {
+            return &timers[i];
+        }
+    }
+    return NULL;
+}
+
+uint64_t fake_esp_timer_period_us(esp_timer_handle_t timer)
+{
+    return timer->period_us;
+}
+
+void fake_esp_timer_fire(esp_timer_handle_t timer)
+{
+    timer->args.callback(timer->args.arg);
+}
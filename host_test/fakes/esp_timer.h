@@ -0,0 +1,30 @@
+#ifndef HOST_FAKE_ESP_TIMER_H
+#define HOST_FAKE_ESP_TIMER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Microseconds on CLOCK_MONOTONIC
+int64_t esp_timer_get_time(void);
+
+// Timers are recorded but never fire by themselves; the test fires them
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+
+// Test hooks: look a timer up by name, read its period (0 while stopped),
+// run its callback
+esp_timer_handle_t fake_esp_timer_find(const char *name);
+uint64_t fake_esp_timer_period_us(esp_timer_handle_t timer);
+void fake_esp_timer_fire(esp_timer_handle_t timer);
+
+#endif
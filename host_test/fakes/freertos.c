@@ -0,0 +1,264 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define MAX_TASKS 16
+
+struct fake_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    const char *name;
+    uint32_t stack_size;
+    pthread_mutex_t lock;
+    pthread_cond_t notified;
+    uint32_t value;
+    bool pending;
+};
+
+struct fake_semaphore {
+    pthread_mutex_t lock;
+    pthread_cond_t given;
+    int count;
+};
+
+_Static_assert(sizeof(struct fake_semaphore) <= sizeof(StaticSemaphore_t), "StaticSemaphore_t too small");
+
+static struct fake_task tasks[MAX_TASKS];
+static int task_count;
+static int fail_creates;
+static pthread_mutex_t tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t critical = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+void fake_enter_critical(void)
+{
+    pthread_mutex_lock(&critical);
+}
+
+void fake_exit_critical(void)
+{
+    pthread_mutex_unlock(&critical);
+}
+
+// Absolute CLOCK_REALTIME deadline ticks (ms) from now
+static struct timespec deadline(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ticks / 1000;
+    ts.tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+static void *task_main(void *arg)
+{
+    struct fake_task *task = arg;
+    task->fn(task->arg);
+    return NULL;
+}
+
+static struct fake_task *create(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg)
+{
+    pthread_mutex_lock(&tasks_lock);
+    struct fake_task *task = NULL;
+    if (fail_creates > 0) {
+        fail_creates--;
+    } else if (task_count < MAX_TASKS) {
+        task = &tasks[task_count++];
+    }
+    pthread_mutex_unlock(&tasks_lock);
+    if (task == NULL) {
+        return NULL;
+    }
+
+    task->fn = fn;
+    task->arg = arg;
+    task->name = name;
+    task->stack_size = stack_size;
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_cond_init(&task->notified, NULL);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_create(&task->thread, &attr, task_main, task);
+    pthread_attr_destroy(&attr);
+    return task;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core)
+{
+    (void)priority;
+    (void)core;
+    TaskHandle_t task = create(fn, name, stack_size, arg);
+    if (handle != NULL) {
+        *handle = task;
+    }
+    return task != NULL ? pdPASS : pdFAIL;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                                           UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb,
+                                           BaseType_t core)
+{
+    (void)priority;
+    (void)core;
+    if (stack == NULL || tcb == NULL) {
+        return NULL;
+    }
+    return create(fn, name, stack_size, arg);
+}
+
+void fake_task_fail_creates(int n)
+{
+    pthread_mutex_lock(&tasks_lock);
+    fail_creates = n;
+    pthread_mutex_unlock(&tasks_lock);
+}
+
+static struct fake_task *current(void)
+{
+    pthread_t self = pthread_self();
+    for (int i = 0; i < task_count; i++) {
+        if (pthread_equal(tasks[i].thread, self)) {
+            return &tasks[i];
+        }
+    }
+    return NULL;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == current()) {
+        pthread_exit(NULL);
+    }
+    pthread_cancel(task->thread);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = { .tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+TaskHandle_t xTaskGetHandle(const char *name)
+{
+    for (int i = 0; i < task_count; i++) {
+        if (strcmp(tasks[i].name, name) == 0) {
+            return &tasks[i];
+        }
+    }
+    return NULL;
+}
+
+// There is no stack to measure; report half of it as never used
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    configASSERT(task != NULL);
+    return task->stack_size / 2;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    pthread_mutex_lock(&task->lock);
+    switch (action) {
+    case eSetBits:               task->value |= value; break;
+    case eIncrement:             task->value++; break;
+    case eSetValueWithOverwrite: task->value = value; break;
+    case eNoAction:              break;
+    }
+    task->pending = true;
+    pthread_cond_signal(&task->notified);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks)
+{
+    struct fake_task *task = current();
+    configASSERT(task != NULL);
+    struct timespec until = deadline(ticks);
+
+    pthread_mutex_lock(&task->lock);
+    if (!task->pending) {
+        task->value &= ~clear_on_entry;
+    }
+    while (!task->pending) {
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&task->notified, &task->lock);
+        } else if (pthread_cond_timedwait(&task->notified, &task->lock, &until) == ETIMEDOUT) {
+            break;
+        }
+    }
+    BaseType_t got = task->pending ? pdTRUE : pdFALSE;
+    if (value != NULL) {
+        *value = task->value;
+    }
+    if (got) {
+        task->value &= ~clear_on_exit;
+        task->pending = false;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return got;
+}
+
+static SemaphoreHandle_t semaphore_init(StaticSemaphore_t *buf, int count)
+{
+    struct fake_semaphore *sem = (struct fake_semaphore *)buf;
+    pthread_mutex_init(&sem->lock, NULL);
+    pthread_cond_init(&sem->given, NULL);
+    sem->count = count;
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf)
+{
+    return semaphore_init(buf, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf)
+{
+    return semaphore_init(buf, 0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    struct timespec until = deadline(ticks);
+
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0) {
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&sem->given, &sem->lock);
+        } else if (ticks == 0 ||
+                   pthread_cond_timedwait(&sem->given, &sem->lock, &until) == ETIMEDOUT) {
+            break;
+        }
+    }
+    BaseType_t got = sem->count > 0 ? pdTRUE : pdFALSE;
+    if (got) {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return got;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    BaseType_t given = sem->count == 0 ? pdTRUE : pdFALSE;
+    sem->count = 1;
+    pthread_cond_signal(&sem->given);
+    pthread_mutex_unlock(&sem->lock);
+    return given;
+}
@@ -0,0 +1,45 @@
+#ifndef HOST_FAKE_FREERTOS_H
+#define HOST_FAKE_FREERTOS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Just enough FreeRTOS for the components, on pthreads. Ticks are 1 ms and
+// every critical section shares one recursive lock.
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;            // ESP-IDF sizes stacks in bytes
+
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+#define portMAX_DELAY       ((TickType_t)0xffffffff)
+#define configTICK_RATE_HZ  1000
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void fake_enter_critical(void);
+void fake_exit_critical(void);
+
+#define portENTER_CRITICAL(mux)     do { (void)(mux); fake_enter_critical(); } while (0)
+#define portEXIT_CRITICAL(mux)      do { (void)(mux); fake_exit_critical(); } while (0)
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux)  portEXIT_CRITICAL(mux)
+
+#define configASSERT(x) do { \
+        if (!(x)) { \
+            fprintf(stderr, "%s:%d: configASSERT(%s) failed\n", __FILE__, __LINE__, #x); \
+            abort(); \
+        } \
+    } while (0)
+
+#endif
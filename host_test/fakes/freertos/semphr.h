@@ -0,0 +1,19 @@
+#ifndef HOST_FAKE_FREERTOS_SEMPHR_H
+#define HOST_FAKE_FREERTOS_SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct fake_semaphore *SemaphoreHandle_t;
+
+// Holds the semaphore itself, so the static variants need no allocation
+typedef struct {
+    void *unused[16];
+} StaticSemaphore_t;
+
+// A mutex starts given, a binary semaphore taken; neither counts above 1
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+#endif
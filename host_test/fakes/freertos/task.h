@@ -0,0 +1,45 @@
+#ifndef HOST_FAKE_FREERTOS_TASK_H
+#define HOST_FAKE_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct fake_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// Storage the static variants are given; the fake keeps its state elsewhere
+typedef struct {
+    void *unused[4];
+} StaticTask_t;
+
+typedef enum {
+    eNoAction,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+} eNotifyAction;
+
+#define tskNO_AFFINITY 0x7fffffff
+
+// Every task runs on its own detached thread from creation
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core);
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                                           UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb,
+                                           BaseType_t core);
+#define xTaskCreate(fn, name, stack_size, arg, priority, handle) \
+    xTaskCreatePinnedToCore(fn, name, stack_size, arg, priority, handle, tskNO_AFFINITY)
+#define xTaskCreateStatic(fn, name, stack_size, arg, priority, stack, tcb) \
+    xTaskCreateStaticPinnedToCore(fn, name, stack_size, arg, priority, stack, tcb, tskNO_AFFINITY)
+
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetHandle(const char *name);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value, TickType_t ticks);
+
+// Test hook: make the next n task creations fail, as when memory runs out
+void fake_task_fail_creates(int n);
+
+#endif
@@ -0,0 +1,106 @@
+#include <stdbool.h>
+#include <string.h>
+#include "driver/gpio.h"
+
+typedef struct {
+    bool configured;
+    gpio_config_t cfg;
+    int level;
+    gpio_isr_t isr;
+    void *arg;
+} pin_t;
+
+static pin_t pins[GPIO_NUM_MAX];
+static bool isr_service;
+
+static bool valid(gpio_num_t pin)
+{
+    return pin >= 0 && pin < GPIO_NUM_MAX;
+}
+
+void fake_gpio_reset(void)
+{
+    memset(pins, 0, sizeof(pins));
+    isr_service = false;
+}
+
+const gpio_config_t *fake_gpio_config(gpio_num_t pin)
+{
+    return valid(pin) && pins[pin].configured ? &pins[pin].cfg : NULL;
+}
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    if (cfg->pin_bit_mask == 0 || cfg->pin_bit_mask >> GPIO_NUM_MAX != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < GPIO_NUM_MAX; i++) {
+        if (cfg->pin_bit_mask & (1ULL << i)) {
+            pins[i].configured = true;
+            pins[i].cfg = *cfg;
+            pins[i].cfg.pin_bit_mask = 1ULL << i;
+            pins[i].level = cfg->pull_up_en == GPIO_PULLUP_ENABLE;
+        }
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    return valid(pin) ? pins[pin].level : 0;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].level = level != 0;
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int flags)
+{
+    (void)flags;
+    if (isr_service) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    isr_service = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t isr, void *arg)
+{
+    if (!isr_service) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!valid(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pins[pin].isr = isr;
+    pins[pin].arg = arg;
+    return ESP_OK;
+}
+
+void fake_gpio_drive(gpio_num_t pin, int level)
+{
+    if (!valid(pin)) {
+        return;
+    }
+    pin_t *p = &pins[pin];
+    int prev = p->level;
+    p->level = level != 0;
+
+    bool fire = false;
+    switch (p->cfg.intr_type) {
+    case GPIO_INTR_POSEDGE:    fire = !prev && p->level; break;
+    case GPIO_INTR_NEGEDGE:    fire = prev && !p->level; break;
+    case GPIO_INTR_ANYEDGE:    fire = prev != p->level; break;
+    case GPIO_INTR_LOW_LEVEL:  fire = !p->level; break;
+    case GPIO_INTR_HIGH_LEVEL: fire = p->level; break;
+    case GPIO_INTR_DISABLE:    break;
+    }
+    if (fire && p->isr != NULL) {
+        p->isr(p->arg);
+    }
+}
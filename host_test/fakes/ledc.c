@@ -0,0 +1,93 @@
+#include <stdbool.h>
+#include "driver/ledc.h"
+
+typedef struct {
+    bool configured;
+    ledc_timer_config_t cfg;
+} timer_state_t;
+
+typedef struct {
+    bool configured;
+    ledc_channel_config_t cfg;
+    uint32_t duty;          // set, waiting for ledc_update_duty()
+} channel_state_t;
+
+static timer_state_t timers[LEDC_TIMER_MAX];
+static channel_state_t channels[LEDC_CHANNEL_MAX];
+
+const ledc_timer_config_t *fake_ledc_timer(ledc_timer_t timer)
+{
+    return timer < LEDC_TIMER_MAX && timers[timer].configured ? &timers[timer].cfg : NULL;
+}
+
+const ledc_channel_config_t *fake_ledc_channel(ledc_channel_t channel)
+{
+    return channel < LEDC_CHANNEL_MAX && channels[channel].configured ? &channels[channel].cfg : NULL;
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *cfg)
+{
+    if (cfg->speed_mode >= LEDC_SPEED_MODE_MAX || cfg->timer_num >= LEDC_TIMER_MAX || cfg->freq_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    timers[cfg->timer_num].configured = true;
+    timers[cfg->timer_num].cfg = *cfg;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *cfg)
+{
+    if (cfg->speed_mode >= LEDC_SPEED_MODE_MAX || cfg->channel >= LEDC_CHANNEL_MAX ||
+        cfg->timer_sel >= LEDC_TIMER_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channels[cfg->channel].configured = true;
+    channels[cfg->channel].cfg = *cfg;
+    channels[cfg->channel].duty = cfg->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_freq(ledc_mode_t mode, ledc_timer_t timer, uint32_t freq_hz)
+{
+    if (fake_ledc_timer(timer) == NULL || mode != timers[timer].cfg.speed_mode) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timers[timer].cfg.freq_hz = freq_hz;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_freq(ledc_mode_t mode, ledc_timer_t timer)
+{
+    const ledc_timer_config_t *cfg = fake_ledc_timer(timer);
+    return cfg != NULL && cfg->speed_mode == mode ? cfg->freq_hz : 0;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty)
+{
+    const ledc_channel_config_t *cfg = fake_ledc_channel(channel);
+    if (cfg == NULL || cfg->speed_mode != mode) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const ledc_timer_config_t *timer = fake_ledc_timer(cfg->timer_sel);
+    if (timer != NULL && duty > (1u << timer->duty_resolution)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channels[channel].duty = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t channel)
+{
+    const ledc_channel_config_t *cfg = fake_ledc_channel(channel);
+    if (cfg == NULL || cfg->speed_mode != mode) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channels[channel].cfg.duty = channels[channel].duty;
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t mode, ledc_channel_t channel)
+{
+    const ledc_channel_config_t *cfg = fake_ledc_channel(channel);
+    return cfg != NULL && cfg->speed_mode == mode ? cfg->duty : 0;
+}
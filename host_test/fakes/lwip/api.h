@@ -0,0 +1,22 @@
+#ifndef HOST_FAKE_LWIP_API_H
+#define HOST_FAKE_LWIP_API_H
+
+#include <stdint.h>
+#include "lwip/pbuf.h"
+
+typedef int8_t err_t;
+#define ERR_OK    0
+#define ERR_CLSD -15
+
+// There is no network on the host: a netconn never delivers data, so
+// pbuf_reader only ever reads fixed chains
+struct netconn;
+
+struct netbuf {
+    struct pbuf *p;
+};
+
+err_t netconn_recv(struct netconn *conn, struct netbuf **new_buf);
+void netbuf_delete(struct netbuf *buf);
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef HOST_FAKE_LWIP_PBUF_H
+#define HOST_FAKE_LWIP_PBUF_H
+
+#include <stdint.h>
+
+typedef uint16_t u16_t;
+
+// The fields of lwIP's struct pbuf that the receive path reads
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+};
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+#endif
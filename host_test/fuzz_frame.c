@@ -0,0 +1,20 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "decode_bench.h"
+
+// libFuzzer entry point. The first byte picks the pbuf segment size and the
+// rest is a byte stream as received on port 3333. The buffer and pbuf
+// receive paths must decode the same frames from it; a disagreement aborts
+// so the fuzzer keeps the input.
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+
+    decode_bench_paths_t result;
+    if (!decode_bench_compare_paths(data + 1, size - 1, 1 + data[0] % 32, &result)) {
+        abort();
+    }
+    return 0;
+}
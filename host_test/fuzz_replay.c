@@ -0,0 +1,90 @@
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// Stand-in for the libFuzzer driver on compilers without -fsanitize=fuzzer:
+// run every file named on the command line, or found in a named directory,
+// through the harness once
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+static int replay_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        uint8_t *grown = realloc(data, size + n);
+        if (grown == NULL) {
+            free(data);
+            fclose(f);
+            return -1;
+        }
+        data = grown;
+        memcpy(data + size, chunk, n);
+        size += n;
+    }
+    fclose(f);
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return 1;
+}
+
+static int replay_path(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return -1;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return replay_file(path);
+    }
+
+    DIR *dir = opendir(path);
+    if (dir == NULL) {
+        perror(path);
+        return -1;
+    }
+
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+
+        char file[4096];
+        snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+        int replayed = replay_file(file);
+        if (replayed < 0) {
+            count = -1;
+            break;
+        }
+        count += replayed;
+    }
+    closedir(dir);
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    int total = 0;
+    for (int i = 1; i < argc; i++) {
+        int count = replay_path(argv[i]);
+        if (count < 0) {
+            return 1;
+        }
+        total += count;
+    }
+    printf("replayed %d inputs\n", total);
+    return 0;
+}
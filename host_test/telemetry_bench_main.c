@@ -0,0 +1,8 @@
+#include "telemetry_bench.h"
+
+// The on-device TELEMETRY_BENCH=1 run, on the host: SensorData per sample
+// against SensorBatch at two scales
+int main(void)
+{
+    return telemetry_bench_run() == 0 ? 0 : 1;
+}
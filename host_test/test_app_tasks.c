@@ -0,0 +1,101 @@
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "app_tasks.h"
+#include "esp_timer.h"
+
+// app_tasks.c on the FreeRTOS and esp_timer fakes. Built twice, with
+// CONFIG_APP_STATIC_ALLOC on and off.
+
+static atomic_int started;
+
+static void task_fn(void *arg)
+{
+    (void)arg;
+    atomic_fetch_add(&started, 1);
+    while (1) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+#define STACK_A 2048
+#define STACK_B 3072
+
+#if CONFIG_APP_STATIC_ALLOC
+static StackType_t stack_a[STACK_A], stack_b[STACK_B];
+static StaticTask_t tcb_a, tcb_b;
+#endif
+
+// Written the way the apps write their tables
+static app_task_t tasks[] = {
+    { task_fn, "task_a", STACK_A, 5, 0, APP_TASK_BUFFERS(stack_a, tcb_a) },
+    { task_fn, "task_b", STACK_B, 4, tskNO_AFFINITY, APP_TASK_BUFFERS(stack_b, tcb_b) },
+};
+
+static void test_start(void)
+{
+    app_tasks_start(tasks, APP_TASK_COUNT(tasks));
+
+    for (int i = 0; i < APP_TASK_COUNT(tasks); i++) {
+        CHECK(tasks[i].handle != NULL);
+        CHECK(tasks[i].handle == xTaskGetHandle(tasks[i].name));
+    }
+    for (int wait_ms = 0; atomic_load(&started) < APP_TASK_COUNT(tasks) && wait_ms < 1000; wait_ms++) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    CHECK_EQ(atomic_load(&started), APP_TASK_COUNT(tasks));
+}
+
+static void test_memory_report(void)
+{
+    CHECK_EQ(app_tasks_start_memory_report(), ESP_OK);
+
+    esp_timer_handle_t timer = fake_esp_timer_find("mem_report");
+    CHECK(timer != NULL);
+    if (timer == NULL) {
+        return;
+    }
+    CHECK_EQ(fake_esp_timer_period_us(timer), (uint64_t)CONFIG_APP_MEM_REPORT_INTERVAL_S * 1000000);
+    fake_esp_timer_fire(timer);
+}
+
+// Tasks from elsewhere join the report; a NULL handle is left out rather
+// than read
+static void test_register(void)
+{
+    TaskHandle_t handle = NULL;
+    CHECK_EQ(xTaskCreate(task_fn, "other", 1024, NULL, 1, &handle), pdPASS);
+    app_tasks_register("other", handle, 1024);
+    app_tasks_register("missing", NULL, 1024);
+    app_tasks_log_memory();
+}
+
+// A task that cannot be created stops the app instead of leaving a NULL handle
+static void test_create_failure(void)
+{
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        static app_task_t one[] = {
+            { task_fn, "task_c", STACK_A, 5, 0, APP_TASK_BUFFERS(stack_a, tcb_a) },
+        };
+        fake_task_fail_creates(1);
+        app_tasks_start(one, APP_TASK_COUNT(one));
+        _exit(0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+}
+
+int main(void)
+{
+    test_start();
+    test_memory_report();
+    test_register();
+    test_create_failure();
+    return host_test_result("test_app_tasks");
+}
@@ -0,0 +1,60 @@
+#include "host_test.h"
+#include "buzzer.h"
+#include "driver/ledc.h"
+
+// buzzer.c on the LEDC fake, with the Kconfig default pin
+
+#define BUZZER_TIMER   LEDC_TIMER_1
+#define BUZZER_CHANNEL LEDC_CHANNEL_1
+
+static void test_init(void)
+{
+    CHECK_EQ(buzzer_init(), ESP_OK);
+
+    const ledc_timer_config_t *timer = fake_ledc_timer(BUZZER_TIMER);
+    const ledc_channel_config_t *channel = fake_ledc_channel(BUZZER_CHANNEL);
+    CHECK(timer != NULL && channel != NULL);
+    if (timer == NULL || channel == NULL) {
+        return;
+    }
+    CHECK_EQ(channel->gpio_num, CONFIG_BUZZER_GPIO);
+    CHECK_EQ(channel->timer_sel, BUZZER_TIMER);
+    CHECK_EQ(ledc_get_duty(LEDC_LOW_SPEED_MODE, BUZZER_CHANNEL), 0);
+
+    // Timer 0 and channel 0 are left to the stepper
+    CHECK(fake_ledc_timer(LEDC_TIMER_0) == NULL);
+    CHECK(fake_ledc_channel(LEDC_CHANNEL_0) == NULL);
+}
+
+// A square wave at the requested pitch until stopped
+static void test_start_stop(void)
+{
+    const ledc_timer_config_t *timer = fake_ledc_timer(BUZZER_TIMER);
+    uint32_t half = timer != NULL ? 1u << (timer->duty_resolution - 1) : 0;
+
+    buzzer_start(2000);
+    CHECK_EQ(ledc_get_freq(LEDC_LOW_SPEED_MODE, BUZZER_TIMER), 2000);
+    CHECK_EQ(ledc_get_duty(LEDC_LOW_SPEED_MODE, BUZZER_CHANNEL), half);
+
+    buzzer_stop();
+    CHECK_EQ(ledc_get_duty(LEDC_LOW_SPEED_MODE, BUZZER_CHANNEL), 0);
+}
+
+static void test_beep(void)
+{
+    int64_t start = host_time_ns();
+    buzzer_beep(3000, 20);
+    int64_t elapsed_ms = (host_time_ns() - start) / 1000000;
+
+    CHECK(elapsed_ms >= 20);
+    CHECK_EQ(ledc_get_freq(LEDC_LOW_SPEED_MODE, BUZZER_TIMER), 3000);
+    CHECK_EQ(ledc_get_duty(LEDC_LOW_SPEED_MODE, BUZZER_CHANNEL), 0);
+}
+
+int main(void)
+{
+    test_init();
+    test_start_stop();
+    test_beep();
+    return host_test_result("test_buzzer");
+}
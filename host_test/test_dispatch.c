@@ -0,0 +1,139 @@
+#include <string.h>
+#include "host_test.h"
+#include "dispatch.h"
+#include "frame.h"
+
+#define BENCH_FRAMES 64
+#define BENCH_ROUNDS 20000
+
+// The frame mix a driving client produces: mostly sensor readings and
+// control commands, with the occasional stats request that needs a reply
+static const pb_size_t bench_mix[] = {
+    Envelope_sensor_tag, Envelope_control_tag, Envelope_sensor_tag, Envelope_control_tag,
+    Envelope_sensor_tag, Envelope_control_tag, Envelope_sensor_tag, Envelope_stats_request_tag,
+};
+#define BENCH_MIX_LEN (sizeof(bench_mix) / sizeof(bench_mix[0]))
+
+// Envelope is sized for stats replies, so keep these off the stack
+static Envelope rx_env;
+static Envelope tx_env;
+static uint8_t tx_buf[FRAME_HEADER_LEN + Envelope_size];
+
+static long handled[DISPATCH_MAX_TAG + 1];
+
+static bool count_handler(const Envelope *env, Envelope *reply, void *ctx)
+{
+    handled[env->which_payload]++;
+    if (ctx == NULL) {
+        return false;
+    }
+    reply->which_payload = Envelope_stats_tag;
+    reply->payload.stats.free_heap = (uint32_t)handled[env->which_payload];
+    return true;
+}
+
+static void test_register(void)
+{
+    CHECK(!dispatch_register(0, count_handler, NULL));
+    CHECK(!dispatch_register(DISPATCH_MAX_TAG + 1, count_handler, NULL));
+    CHECK(dispatch_register(DISPATCH_MAX_TAG, count_handler, NULL));
+    CHECK(dispatch_register(DISPATCH_MAX_TAG, NULL, NULL));
+}
+
+static void test_dispatch(void)
+{
+    memset(handled, 0, sizeof(handled));
+    dispatch_register(Envelope_sensor_tag, count_handler, NULL);
+    dispatch_register(Envelope_stats_request_tag, count_handler, &tx_env);
+    dispatch_register(Envelope_control_tag, NULL, NULL);
+
+    memset(&rx_env, 0, sizeof(rx_env));
+    CHECK_EQ(dispatch_envelope(&rx_env, &tx_env), DISPATCH_UNHANDLED);
+
+    rx_env.which_payload = Envelope_control_tag;
+    CHECK_EQ(dispatch_envelope(&rx_env, &tx_env), DISPATCH_UNHANDLED);
+
+    rx_env.which_payload = DISPATCH_MAX_TAG + 1;
+    CHECK_EQ(dispatch_envelope(&rx_env, &tx_env), DISPATCH_UNHANDLED);
+
+    rx_env.which_payload = Envelope_sensor_tag;
+    CHECK_EQ(dispatch_envelope(&rx_env, &tx_env), DISPATCH_DONE);
+    CHECK_EQ(handled[Envelope_sensor_tag], 1);
+
+    rx_env.which_payload = Envelope_stats_request_tag;
+    CHECK_EQ(dispatch_envelope(&rx_env, &tx_env), DISPATCH_REPLY);
+    CHECK_EQ(tx_env.which_payload, Envelope_stats_tag);
+}
+
+// Decode, dispatch and answer a receive buffer of mixed frames, as the
+// server task does for each frame it reads
+static void bench_mixed(void)
+{
+    static uint8_t rx_buf[BENCH_FRAMES * (FRAME_HEADER_LEN + FRAME_MAX_LEN)];
+    size_t rx_len = 0;
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        Envelope *env = &rx_env;
+        memset(env, 0, sizeof(*env));
+        env->which_payload = bench_mix[i % BENCH_MIX_LEN];
+        if (env->which_payload == Envelope_control_tag) {
+            env->payload.control.id = 100000 + i;
+            env->payload.control.speed = 0.75f;
+            env->payload.control.steering = -0.25f;
+            env->payload.control.enable = true;
+        } else if (env->which_payload == Envelope_sensor_tag) {
+            env->payload.sensor.temperature = 21.5f + i % 10;
+            env->payload.sensor.humidity = 48.25f;
+        }
+
+        size_t written;
+        CHECK(frame_encode(env, rx_buf + rx_len, sizeof(rx_buf) - rx_len, &written));
+        rx_len += written;
+    }
+
+    memset(handled, 0, sizeof(handled));
+    dispatch_register(Envelope_sensor_tag, count_handler, NULL);
+    dispatch_register(Envelope_control_tag, count_handler, NULL);
+    dispatch_register(Envelope_stats_request_tag, count_handler, &tx_env);
+
+    long replies = 0;
+    size_t reply_bytes = 0;
+    int64_t start = host_time_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        size_t off = 0;
+        while (off < rx_len) {
+            size_t consumed;
+            if (frame_decode(rx_buf + off, rx_len - off, &rx_env, &consumed) != FRAME_OK) {
+                CHECK(!"frame_decode failed");
+                return;
+            }
+            off += consumed;
+
+            if (dispatch_envelope(&rx_env, &tx_env) == DISPATCH_REPLY) {
+                size_t len;
+                CHECK(frame_encode(&tx_env, tx_buf, sizeof(tx_buf), &len));
+                reply_bytes += len;
+                replies++;
+            }
+        }
+    }
+    int64_t elapsed = host_time_ns() - start;
+
+    long frames = (long)BENCH_FRAMES * BENCH_ROUNDS;
+    CHECK_EQ(handled[Envelope_sensor_tag] + handled[Envelope_control_tag] +
+             handled[Envelope_stats_request_tag], frames);
+    CHECK_EQ(handled[Envelope_stats_request_tag], replies);
+    CHECK_EQ(replies, (long)BENCH_ROUNDS * (BENCH_FRAMES / BENCH_MIX_LEN));
+
+    printf("BENCH {\"bench\":\"dispatch\",\"op\":\"mixed\",\"frames\":%ld,\"bytes\":%zu,"
+           "\"replies\":%ld,\"reply_bytes\":%zu,\"ns_per_frame\":%lld,\"frames_per_s\":%lld}\n",
+           frames, rx_len * BENCH_ROUNDS, replies, reply_bytes,
+           (long long)(elapsed / frames), (long long)(frames * 1000000000LL / elapsed));
+}
+
+int main(void)
+{
+    test_register();
+    test_dispatch();
+    bench_mixed();
+    return host_test_result("test_dispatch");
+}
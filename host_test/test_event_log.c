@@ -0,0 +1,244 @@
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "event_log.h"
+
+// The ring code in event_log.c on a RAM partition. event_log_init() runs
+// once per process, so every scenario gets a fresh child.
+
+#define SECTORS 4
+#define SECTOR  EVENT_LOG_SECTOR_SIZE
+#define LABEL   CONFIG_EVENT_LOG_PARTITION_LABEL
+
+// Put a sector on the fake partition as the writer would have, holding one
+// IR record
+static void put_sector(uint32_t index, uint32_t seq, uint16_t boot)
+{
+    uint8_t buf[SECTOR];
+    size_t pos = sizeof(event_log_sector_hdr_t);
+    event_ir_t ev = { .count = (uint16_t)seq };
+    event_log_append(buf, sizeof(buf), &pos, EVENT_IR_DETECTION, 0, &ev, sizeof(ev));
+
+    event_log_sector_hdr_t hdr = {
+        .magic = EVENT_LOG_MAGIC,
+        .seq = seq,
+        .boot = boot,
+        .used = pos - sizeof(hdr),
+        .crc = esp_rom_crc32_le(0, buf + sizeof(hdr), pos - sizeof(hdr)),
+    };
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    uint8_t *flash = fake_partition_data() + index * SECTOR;
+    memset(flash, 0xff, SECTOR);
+    memcpy(flash, buf, pos);
+}
+
+// Sequence number in the header at offset in the log, as a reader sees it
+static uint32_t seq_at(uint32_t offset)
+{
+    event_log_sector_hdr_t hdr;
+    if (event_log_read(offset, &hdr, sizeof(hdr), NULL) != ESP_OK || hdr.magic != EVENT_LOG_MAGIC) {
+        return UINT32_MAX;
+    }
+    return hdr.seq;
+}
+
+static void record_and_flush(void)
+{
+    event_log_ir(1);
+    CHECK_EQ(event_log_flush(), ESP_OK);
+}
+
+static void test_fresh(void)
+{
+    CHECK(event_log_writer_task() == NULL);
+    CHECK_EQ(event_log_init(), ESP_OK);
+    CHECK(event_log_writer_task() != NULL);
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_size(&first_seq), 0);
+
+    record_and_flush();
+    CHECK_EQ(event_log_size(&first_seq), SECTOR);
+    CHECK_EQ(first_seq, 0);
+    CHECK_EQ(seq_at(0), 0);
+}
+
+// Before the ring has gone round the log starts at sector 0
+static void test_resume(void)
+{
+    put_sector(0, 0, 0);
+    put_sector(1, 1, 0);
+    CHECK_EQ(event_log_init(), ESP_OK);
+
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_size(&first_seq), 2 * SECTOR);
+    CHECK_EQ(first_seq, 0);
+
+    record_and_flush();
+    CHECK_EQ(event_log_size(&first_seq), 3 * SECTOR);
+    CHECK_EQ(first_seq, 0);
+    CHECK_EQ(seq_at(2 * SECTOR), 2);
+
+    // The next boot carries on the numbering with a new boot count
+    event_log_sector_hdr_t hdr;
+    memcpy(&hdr, fake_partition_data() + 2 * SECTOR, sizeof(hdr));
+    CHECK_EQ(hdr.boot, 1);
+}
+
+// After a wrap the oldest sector sits right after the newest one
+static void test_resume_after_wrap(void)
+{
+    put_sector(0, 4, 1);
+    put_sector(1, 5, 1);
+    put_sector(2, 2, 0);
+    put_sector(3, 3, 0);
+    CHECK_EQ(event_log_init(), ESP_OK);
+
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_size(&first_seq), SECTORS * SECTOR);
+    CHECK_EQ(first_seq, 2);
+    for (uint32_t i = 0; i < SECTORS; i++) {
+        CHECK_EQ(seq_at(i * SECTOR), 2 + i);
+    }
+
+    // A full ring drops its oldest sector for each one written
+    record_and_flush();
+    CHECK_EQ(event_log_size(&first_seq), SECTORS * SECTOR);
+    CHECK_EQ(first_seq, 3);
+    CHECK_EQ(seq_at(0), 3);
+    CHECK_EQ(seq_at((SECTORS - 1) * SECTOR), 6);
+
+    // Reads run across the end of the partition in log order
+    uint8_t across[32];
+    CHECK_EQ(event_log_read(SECTOR - 16, across, sizeof(across), NULL), ESP_OK);
+    CHECK(memcmp(across, fake_partition_data() + 4 * SECTOR - 16, 16) == 0);
+    CHECK(memcmp(across + 16, fake_partition_data(), 16) == 0);
+}
+
+// Power lost after erasing the oldest sector for the next write: the log
+// starts at the sector after it, with that sector's seq
+static void test_resume_after_torn_sector(void)
+{
+    put_sector(0, 4, 1);
+    put_sector(1, 5, 1);
+    memset(fake_partition_data() + 2 * SECTOR, 0xff, SECTOR);
+    put_sector(3, 3, 0);
+    CHECK_EQ(event_log_init(), ESP_OK);
+
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_size(&first_seq), 3 * SECTOR);
+    CHECK_EQ(first_seq, 3);
+    CHECK_EQ(seq_at(0), 3);
+    CHECK_EQ(seq_at(2 * SECTOR), 5);
+
+    // The torn sector is written next and the log grows back to the full ring
+    record_and_flush();
+    CHECK_EQ(event_log_size(&first_seq), SECTORS * SECTOR);
+    CHECK_EQ(first_seq, 3);
+    CHECK_EQ(seq_at(3 * SECTOR), 6);
+}
+
+// A header cut short mid-write has the magic but not the rest
+static void test_resume_after_torn_header(void)
+{
+    put_sector(0, 4, 1);
+    put_sector(1, 5, 1);
+    put_sector(2, 2, 0);
+    put_sector(3, 3, 0);
+    event_log_sector_hdr_t *hdr = (event_log_sector_hdr_t *)(fake_partition_data() + 2 * SECTOR);
+    hdr->used = 0xffff;
+    CHECK_EQ(event_log_init(), ESP_OK);
+
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_size(&first_seq), 3 * SECTOR);
+    CHECK_EQ(first_seq, 3);
+}
+
+// A bad sector further in stays in the log, for the decoder to report
+static void test_invalid_sector_inside(void)
+{
+    put_sector(0, 4, 1);
+    put_sector(1, 5, 1);
+    put_sector(2, 2, 0);
+    memset(fake_partition_data() + 3 * SECTOR, 0xff, SECTOR);
+    CHECK_EQ(event_log_init(), ESP_OK);
+
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_size(&first_seq), SECTORS * SECTOR);
+    CHECK_EQ(first_seq, 2);
+    CHECK_EQ(seq_at(SECTOR), UINT32_MAX);
+    CHECK_EQ(seq_at(2 * SECTOR), 4);
+}
+
+static void test_read_bounds(void)
+{
+    put_sector(0, 0, 0);
+    put_sector(1, 1, 0);
+    CHECK_EQ(event_log_init(), ESP_OK);
+
+    uint8_t buf[16];
+    uint32_t size = event_log_size(NULL);
+    CHECK_EQ(event_log_read(size - sizeof(buf), buf, sizeof(buf), NULL), ESP_OK);
+    CHECK_EQ(event_log_read(size, buf, 0, NULL), ESP_OK);
+    CHECK_EQ(event_log_read(size - 1, buf, 2, NULL), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ(event_log_read(size + 1, buf, 0, NULL), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ(event_log_read(UINT32_MAX, buf, sizeof(buf), NULL), ESP_ERR_INVALID_SIZE);
+
+    uint32_t first_seq = 99;
+    CHECK_EQ(event_log_read(0, buf, sizeof(buf), &first_seq), ESP_OK);
+    CHECK_EQ(first_seq, 0);
+}
+
+// Each flush uses up a sector, so one with nothing staged must not write
+static void test_flush_when_clean(void)
+{
+    CHECK_EQ(event_log_init(), ESP_OK);
+    CHECK_EQ(event_log_flush(), ESP_OK);
+    CHECK_EQ(fake_partition_erase_count(), 0);
+
+    record_and_flush();
+    CHECK_EQ(fake_partition_erase_count(), 1);
+    for (int i = 0; i < 10; i++) {
+        CHECK_EQ(event_log_flush(), ESP_OK);
+    }
+    CHECK_EQ(fake_partition_erase_count(), 1);
+    CHECK_EQ(event_log_size(NULL), SECTOR);
+}
+
+static int run(const char *name, void (*test)(void))
+{
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        fake_partition_create(LABEL, SECTORS * SECTOR);
+        test();
+        fflush(NULL);
+        _exit(host_test_failures > 0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "%s failed\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+#define RUN(test) run(#test, test)
+
+int main(void)
+{
+    host_test_failures += RUN(test_fresh);
+    host_test_failures += RUN(test_resume);
+    host_test_failures += RUN(test_resume_after_wrap);
+    host_test_failures += RUN(test_resume_after_torn_sector);
+    host_test_failures += RUN(test_resume_after_torn_header);
+    host_test_failures += RUN(test_invalid_sector_inside);
+    host_test_failures += RUN(test_read_bounds);
+    host_test_failures += RUN(test_flush_when_clean);
+    return host_test_result("test_event_log");
+}
@@ -0,0 +1,78 @@
+#include <string.h>
+#include "host_test.h"
+#include "event_log_format.h"
+
+#define BENCH_SECTORS 100000
+
+// event_log_decode.py reads these with fixed struct formats
+static void test_layout(void)
+{
+    CHECK_EQ(sizeof(event_log_sector_hdr_t), 16);
+    CHECK_EQ(sizeof(event_log_rec_hdr_t), 6);
+    CHECK_EQ(sizeof(event_ir_t), 2);
+    CHECK_EQ(sizeof(event_motor_t), 8);
+    CHECK_EQ(sizeof(event_command_t), 13);
+}
+
+static void test_append(void)
+{
+    uint8_t buf[64];
+    size_t pos = 16;
+    event_motor_t ev = { .steps = -1066, .freq_hz = 1000 };
+
+    CHECK(event_log_append(buf, sizeof(buf), &pos, EVENT_MOTOR_MOVE, 0x01020304, &ev, sizeof(ev)));
+    CHECK_EQ(pos, 16 + 6 + 8);
+
+    // Little-endian record header, then the payload as is
+    const uint8_t expect[] = { EVENT_MOTOR_MOVE, 8, 0x04, 0x03, 0x02, 0x01 };
+    CHECK(memcmp(buf + 16, expect, sizeof(expect)) == 0);
+    event_motor_t back;
+    memcpy(&back, buf + 16 + 6, sizeof(back));
+    CHECK_EQ(back.steps, -1066);
+    CHECK_EQ(back.freq_hz, 1000);
+
+    // Exactly full still fits, one byte over does not and leaves pos alone
+    event_ir_t ir = { .count = 7 };
+    size_t full = sizeof(buf) - 6 - sizeof(ir);
+    pos = full;
+    CHECK(event_log_append(buf, sizeof(buf), &pos, EVENT_IR_DETECTION, 0, &ir, sizeof(ir)));
+    CHECK_EQ(pos, sizeof(buf));
+    pos = full + 1;
+    CHECK(!event_log_append(buf, sizeof(buf), &pos, EVENT_IR_DETECTION, 0, &ir, sizeof(ir)));
+    CHECK_EQ(pos, full + 1);
+
+    // Empty payloads are allowed
+    pos = 0;
+    CHECK(event_log_append(buf, sizeof(buf), &pos, EVENT_IR_DETECTION, 0, &ir, 0));
+    CHECK_EQ(pos, 6);
+}
+
+// Fill whole sectors with command records, as the recorder does at 100+ Hz
+static void bench_append(void)
+{
+    static uint8_t sector[EVENT_LOG_SECTOR_SIZE];
+    event_command_t ev = { .id = 1, .speed = 0.5f, .steering = -0.25f, .enable = 1 };
+    long records = 0;
+
+    int64_t start = host_time_ns();
+    for (int s = 0; s < BENCH_SECTORS; s++) {
+        size_t pos = sizeof(event_log_sector_hdr_t);
+        while (event_log_append(sector, sizeof(sector), &pos, EVENT_COMMAND, s, &ev, sizeof(ev))) {
+            ev.id++;
+            records++;
+        }
+    }
+    int64_t elapsed = host_time_ns() - start;
+    CHECK_EQ(records, (long)BENCH_SECTORS * ((EVENT_LOG_SECTOR_SIZE - 16) / 19));
+
+    printf("BENCH {\"bench\":\"event_log\",\"op\":\"append\",\"records_per_sector\":%ld,\"ns_per_op\":%.2f}\n",
+           records / BENCH_SECTORS, (double)elapsed / records);
+}
+
+int main(void)
+{
+    test_layout();
+    test_append();
+    bench_append();
+    return host_test_result("test_event_log_format");
+}
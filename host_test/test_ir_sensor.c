@@ -0,0 +1,87 @@
+#include "host_test.h"
+#include "ir_sensor.h"
+
+// ir_sensor.c on the GPIO fake, with the Kconfig defaults
+
+static int isr_calls;
+
+static void count_isr(void *arg)
+{
+    isr_calls += *(int *)arg;
+}
+
+static void test_init(void)
+{
+    fake_gpio_reset();
+    CHECK_EQ(ir_sensor_init(GPIO_INTR_NEGEDGE), ESP_OK);
+
+    const gpio_config_t *cfg = fake_gpio_config(CONFIG_IR_SENSOR_GPIO);
+    CHECK(cfg != NULL);
+    if (cfg == NULL) {
+        return;
+    }
+    CHECK_EQ(cfg->mode, GPIO_MODE_INPUT);
+    CHECK_EQ(cfg->pull_up_en, GPIO_PULLUP_ENABLE);
+    CHECK_EQ(cfg->pull_down_en, GPIO_PULLDOWN_DISABLE);
+    CHECK_EQ(cfg->intr_type, GPIO_INTR_NEGEDGE);
+
+    // Only the sensor pin is touched
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+        CHECK(pin == CONFIG_IR_SENSOR_GPIO || fake_gpio_config(pin) == NULL);
+    }
+}
+
+// The output is active low: the pull-up holds it high with nothing in view
+static void test_object_detected(void)
+{
+    fake_gpio_reset();
+    ir_sensor_init(GPIO_INTR_DISABLE);
+    CHECK(!ir_sensor_object_detected());
+
+    fake_gpio_drive(IR_SENSOR_PIN, 0);
+    CHECK(ir_sensor_object_detected());
+    fake_gpio_drive(IR_SENSOR_PIN, 1);
+    CHECK(!ir_sensor_object_detected());
+}
+
+static void test_add_isr(void)
+{
+    fake_gpio_reset();
+    ir_sensor_init(GPIO_INTR_NEGEDGE);
+    int weight = 1;
+    CHECK_EQ(ir_sensor_add_isr(count_isr, &weight), ESP_OK);
+
+    // Falling edges only, with the arg passed through
+    isr_calls = 0;
+    fake_gpio_drive(IR_SENSOR_PIN, 0);
+    CHECK_EQ(isr_calls, 1);
+    fake_gpio_drive(IR_SENSOR_PIN, 1);
+    CHECK_EQ(isr_calls, 1);
+    weight = 10;
+    fake_gpio_drive(IR_SENSOR_PIN, 0);
+    CHECK_EQ(isr_calls, 11);
+}
+
+// Another component got to the ISR service first
+static void test_add_isr_service_installed(void)
+{
+    fake_gpio_reset();
+    ir_sensor_init(GPIO_INTR_ANYEDGE);
+    CHECK_EQ(gpio_install_isr_service(0), ESP_OK);
+
+    int weight = 1;
+    CHECK_EQ(ir_sensor_add_isr(count_isr, &weight), ESP_OK);
+    isr_calls = 0;
+    fake_gpio_drive(IR_SENSOR_PIN, 0);
+    fake_gpio_drive(IR_SENSOR_PIN, 1);
+    CHECK_EQ(isr_calls, 2);
+}
+
+int main(void)
+{
+    test_init();
+    test_object_detected();
+    test_add_isr();
+    test_add_isr_service_installed();
+    return host_test_result("test_ir_sensor");
+}
@@ -0,0 +1,144 @@
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include "host_test.h"
+#include "latency_hist.h"
+
+#define BENCH_RECORDS     10000000
+#define CONCURRENT_VALUES 3000000
+
+// Bucket by definition: 0 for 0 us, floor(log2(us)) + 1 otherwise, capped
+static int reference_bucket(uint32_t us)
+{
+    int bucket = 0;
+    while (us > 0) {
+        bucket++;
+        us >>= 1;
+    }
+    return bucket < LATENCY_HIST_BUCKETS ? bucket : LATENCY_HIST_BUCKETS - 1;
+}
+
+static void test_bucket_boundaries(void)
+{
+    CHECK_EQ(latency_hist_bucket(0), 0);
+    CHECK_EQ(latency_hist_bucket(1), 1);
+    CHECK_EQ(latency_hist_bucket(UINT32_MAX), LATENCY_HIST_BUCKETS - 1);
+
+    // Either side of every power of two
+    for (int k = 0; k < 32; k++) {
+        uint32_t edge = (uint32_t)1 << k;
+        CHECK_EQ(latency_hist_bucket(edge - 1), reference_bucket(edge - 1));
+        CHECK_EQ(latency_hist_bucket(edge), reference_bucket(edge));
+        CHECK_EQ(latency_hist_bucket(edge + 1), reference_bucket(edge + 1));
+    }
+
+    // Bucket i starts at 2^(i-1) up to the last one, which takes everything above
+    for (int i = 1; i < LATENCY_HIST_BUCKETS; i++) {
+        uint32_t start = (uint32_t)1 << (i - 1);
+        CHECK_EQ(latency_hist_bucket(start), i);
+        CHECK_EQ(latency_hist_bucket(start - 1), i - 1);
+    }
+}
+
+static void test_record_snapshot(void)
+{
+    latency_hist_t hist = LATENCY_HIST_INIT;
+    latency_hist_record(&hist, 0);
+    latency_hist_record(&hist, 5);
+    latency_hist_record(&hist, 5);
+    latency_hist_record(&hist, 900);
+
+    latency_hist_t snap;
+    latency_hist_snapshot(&hist, &snap);
+    CHECK_EQ(snap.count, 4);
+    CHECK_EQ(snap.max_us, 900);
+    CHECK_EQ(snap.buckets[0], 1);
+    CHECK_EQ(snap.buckets[latency_hist_bucket(5)], 2);
+    CHECK_EQ(snap.buckets[latency_hist_bucket(900)], 1);
+    CHECK_EQ(snap.seq, 8);  // two per record, even when idle
+}
+
+// Samples in bucket b after the values 1..n have been recorded
+static uint32_t expected_bucket_count(int b, uint32_t n)
+{
+    if (b == 0) return 0;
+    uint32_t lo = (uint32_t)1 << (b - 1);
+    uint32_t hi = b == LATENCY_HIST_BUCKETS - 1 ? UINT32_MAX : ((uint32_t)1 << b) - 1;
+    if (n < lo) return 0;
+    return (n < hi ? n : hi) - lo + 1;
+}
+
+static latency_hist_t shared_hist = LATENCY_HIST_INIT;
+static volatile bool writer_done;
+
+// The single writer records 1, 2, 3, ... so every consistent state is
+// fully determined by its count
+static void *writer_thread(void *arg)
+{
+    (void)arg;
+    for (uint32_t us = 1; us <= CONCURRENT_VALUES; us++) {
+        latency_hist_record(&shared_hist, us);
+    }
+    __atomic_store_n(&writer_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// A reader snapshotting while the writer runs must only ever see states
+// after a whole number of records, never one torn mid-update
+static void test_concurrent_snapshot(void)
+{
+    pthread_t writer;
+    CHECK(pthread_create(&writer, NULL, writer_thread, NULL) == 0);
+
+    long snapshots = 0;
+    long torn = 0;
+    uint32_t last_count = 0;
+    while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE)) {
+        latency_hist_t snap;
+        latency_hist_snapshot(&shared_hist, &snap);
+        snapshots++;
+
+        bool ok = (snap.seq & 1) == 0 && snap.seq == 2 * snap.count &&
+                  snap.count >= last_count && snap.max_us == snap.count;
+        for (int b = 0; ok && b < LATENCY_HIST_BUCKETS; b++) {
+            ok = snap.buckets[b] == expected_bucket_count(b, snap.count);
+        }
+        if (!ok) torn++;
+        last_count = snap.count;
+    }
+    pthread_join(writer, NULL);
+
+    CHECK_EQ(torn, 0);
+    CHECK(snapshots > 0);
+
+    latency_hist_t final;
+    latency_hist_snapshot(&shared_hist, &final);
+    CHECK_EQ(final.count, CONCURRENT_VALUES);
+    CHECK_EQ(final.max_us, CONCURRENT_VALUES);
+
+    printf("BENCH {\"bench\":\"latency_hist\",\"op\":\"concurrent_snapshot\",\"snapshots\":%ld,"
+           "\"records\":%d,\"torn\":%ld}\n", snapshots, CONCURRENT_VALUES, torn);
+}
+
+static void bench_record(void)
+{
+    static latency_hist_t hist = LATENCY_HIST_INIT;
+    int64_t start = host_time_ns();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+        latency_hist_record(&hist, i & 0xFFFF);
+    }
+    int64_t elapsed = host_time_ns() - start;
+    CHECK_EQ(hist.count, BENCH_RECORDS);
+
+    printf("BENCH {\"bench\":\"latency_hist\",\"op\":\"record\",\"ns_per_op\":%.2f}\n",
+           (double)elapsed / BENCH_RECORDS);
+}
+
+int main(void)
+{
+    test_bucket_boundaries();
+    test_record_snapshot();
+    test_concurrent_snapshot();
+    bench_record();
+    return host_test_result("test_latency_hist");
+}
@@ -0,0 +1,193 @@
+#include "host_test.h"
+#include "stepper_math.h"
+
+// Defaults from components/stepper/Kconfig and stepper_velocity.c
+#define MAX_STEP_HZ   10660.0f
+#define MIN_STEP_HZ   50.0f
+#define MAX_ACCEL     20000.0f
+#define RAMP_PERIOD_S 0.01f
+#define TICK_HZ       10000000
+
+#define SIM_SECONDS   600
+
+static void test_steps_for_deg(void)
+{
+    CHECK_EQ(STEPPER_STEPS_FOR_DEG(6400, 60), 1066);
+    CHECK_EQ(STEPPER_STEPS_FOR_DEG(6400, 360), 6400);
+    CHECK_EQ(STEPPER_STEPS_FOR_DEG(200, 90), 50);
+    CHECK_EQ(STEPPER_STEPS_FOR_DEG(6400, 0), 0);
+}
+
+static void test_move_duration(void)
+{
+    CHECK_EQ(stepper_move_duration_ms(1066, 1000), 1066);
+    CHECK_EQ(stepper_move_duration_ms(6400, 3200), 2000);
+    CHECK_EQ(stepper_move_duration_ms(100, 0), 0);
+    // steps * 1000 must not overflow 32 bits
+    CHECK_EQ(stepper_move_duration_ms(UINT32_MAX, 1000000), 4294967);
+}
+
+static void test_speed_to_hz(void)
+{
+    CHECK(stepper_speed_to_hz(0.5f, MAX_STEP_HZ) == 5330.0f);
+    CHECK(stepper_speed_to_hz(-1.0f, MAX_STEP_HZ) == -MAX_STEP_HZ);
+    CHECK(stepper_speed_to_hz(3.0f, MAX_STEP_HZ) == MAX_STEP_HZ);
+    CHECK(stepper_speed_to_hz(-INFINITY, MAX_STEP_HZ) == -MAX_STEP_HZ);
+    CHECK(stepper_speed_to_hz(NAN, MAX_STEP_HZ) == 0.0f);
+}
+
+static void test_rate_limit(void)
+{
+    // Clamped either way, reached exactly once within reach
+    CHECK(stepper_rate_limit(0.0f, 1000.0f, 200.0f) == 200.0f);
+    CHECK(stepper_rate_limit(1000.0f, 0.0f, 200.0f) == 800.0f);
+    CHECK(stepper_rate_limit(900.0f, 1000.0f, 200.0f) == 1000.0f);
+    CHECK(stepper_rate_limit(100.0f, 0.0f, 200.0f) == 0.0f);
+
+    // Reversing passes through zero at the same rate of change
+    CHECK(stepper_rate_limit(100.0f, -1000.0f, 200.0f) == -100.0f);
+    float rate = MAX_STEP_HZ;
+    int steps = 0;
+    while (rate != -MAX_STEP_HZ && steps < 1000) {
+        float next = stepper_rate_limit(rate, -MAX_STEP_HZ, 200.0f);
+        CHECK(rate - next <= 200.0f);
+        rate = next;
+        steps++;
+    }
+    CHECK_EQ(steps, 107);   // 2 * 10660 / 200, rounded up
+}
+
+static void test_half_period_ticks(void)
+{
+    // Below the minimum rate, or at zero, the timer is stopped
+    CHECK_EQ(stepper_half_period_ticks(0.0f, MIN_STEP_HZ, TICK_HZ), 0);
+    CHECK_EQ(stepper_half_period_ticks(0.0f, 0.0f, TICK_HZ), 0);
+    CHECK_EQ(stepper_half_period_ticks(49.9f, MIN_STEP_HZ, TICK_HZ), 0);
+    CHECK_EQ(stepper_half_period_ticks(-49.9f, MIN_STEP_HZ, TICK_HZ), 0);
+
+    // Either sign gives the same period; the slowest one fits 32 bits easily
+    CHECK_EQ(stepper_half_period_ticks(MIN_STEP_HZ, MIN_STEP_HZ, TICK_HZ), 100000);
+    CHECK_EQ(stepper_half_period_ticks(-MIN_STEP_HZ, MIN_STEP_HZ, TICK_HZ), 100000);
+    CHECK_EQ(stepper_half_period_ticks(MAX_STEP_HZ, MIN_STEP_HZ, TICK_HZ), 469);
+    CHECK_EQ(stepper_half_period_ticks(-MAX_STEP_HZ, MIN_STEP_HZ, TICK_HZ), 469);
+
+    // Rounded to the nearest tick, and never 0 however fast
+    CHECK_EQ(stepper_half_period_ticks(3000.0f, MIN_STEP_HZ, TICK_HZ), 1667);
+    CHECK_EQ(stepper_half_period_ticks(1e9f, MIN_STEP_HZ, TICK_HZ), 1);
+}
+
+static void test_ramp_update(void)
+{
+    const float max_delta = MAX_ACCEL * RAMP_PERIOD_S;
+    float rate = 0.0f;
+
+    // Starts from rest by one step of the limit
+    CHECK_EQ(stepper_ramp_update(&rate, MAX_STEP_HZ, max_delta, false, true, MIN_STEP_HZ, TICK_HZ), 25000);
+    CHECK(rate == 200.0f);
+
+    // Too slow to step: stays stopped
+    rate = 0.0f;
+    CHECK_EQ(stepper_ramp_update(&rate, 30.0f, max_delta, false, true, MIN_STEP_HZ, TICK_HZ), 0);
+    CHECK(rate == 0.0f);
+
+    // Slowing into the band below MIN_STEP_HZ: stop when within the limit,
+    // otherwise one more period at MIN_STEP_HZ
+    rate = 150.0f;
+    CHECK_EQ(stepper_ramp_update(&rate, 0.0f, max_delta, true, true, MIN_STEP_HZ, TICK_HZ), 0);
+    CHECK(rate == 0.0f);
+    rate = 230.0f;
+    CHECK_EQ(stepper_ramp_update(&rate, 0.0f, max_delta, true, true, MIN_STEP_HZ, TICK_HZ), 100000);
+    CHECK(rate == MIN_STEP_HZ);
+
+    // Crossing zero while the timer still runs forward holds at 0, and keeps
+    // holding until it has stopped; then reverse starts from rest
+    rate = 100.0f;
+    CHECK_EQ(stepper_ramp_update(&rate, -MAX_STEP_HZ, max_delta, true, true, MIN_STEP_HZ, TICK_HZ), 0);
+    CHECK(rate == 0.0f);
+    CHECK_EQ(stepper_ramp_update(&rate, -MAX_STEP_HZ, max_delta, true, true, MIN_STEP_HZ, TICK_HZ), 0);
+    CHECK(rate == 0.0f);
+    CHECK_EQ(stepper_ramp_update(&rate, -MAX_STEP_HZ, max_delta, false, true, MIN_STEP_HZ, TICK_HZ), 25000);
+    CHECK(rate == -200.0f);
+}
+
+// Stream a 0.5 Hz full-reverse sine of speed commands at 100 Hz, as
+// "test_client.py drive" does, through stepper_ramp_update() once per ramp
+// period, with the timer modelled the way stepper_velocity.c drives it: a
+// period of 0 stops it after STOP_DELAY updates (the ISR waits for the end
+// of a pulse) and DIR is set when it starts. The step rate the motor sees
+// must never change by more than the acceleration limit per update, starts
+// and stops included, and DIR must never change while the timer runs.
+// max_lag_hz shows how far behind the commands the limit leaves the motor:
+// a full-scale 0.5 Hz sine needs up to 33500 steps/s^2.
+#define STOP_DELAY 2
+
+static void bench_ramp(void)
+{
+    const float max_delta = MAX_ACCEL * RAMP_PERIOD_S;
+    const int updates = (int)(SIM_SECONDS / RAMP_PERIOD_S);
+    float rate = 0.0f;
+    float stepping_hz = 0.0f;   // rate the timer actually produces
+    bool running = false;
+    bool forward = true;
+    int stopping = 0;
+    float max_lag = 0.0f;
+    uint64_t tick_sum = 0;
+    int reversals = 0;
+
+    int64_t start = host_time_ns();
+    for (int i = 0; i < updates; i++) {
+        float speed = sinf(2.0f * (float)M_PI * 0.5f * i * RAMP_PERIOD_S);
+        float target = stepper_speed_to_hz(speed, MAX_STEP_HZ);
+        uint32_t ticks = stepper_ramp_update(&rate, target, max_delta, running, forward, MIN_STEP_HZ, TICK_HZ);
+
+        // The timer: stops a little after being given 0, starts at once
+        if (ticks == 0 && running && ++stopping >= STOP_DELAY) {
+            running = false;
+        }
+        if (ticks > 0 && !running) {
+            reversals += forward != (rate > 0);
+            forward = rate > 0;
+            running = true;
+        }
+        if (ticks > 0) {
+            stopping = 0;
+        }
+
+        float now_hz = ticks > 0 ? rate : 0.0f;
+        if (fabsf(now_hz - stepping_hz) > max_delta) {
+            CHECK(!"step rate changed faster than the acceleration limit");
+        }
+        if (ticks > 0 && (rate > 0) != forward) {
+            CHECK(!"stepping against DIR");
+        }
+        if (ticks != 0 && ticks > TICK_HZ / (2 * MIN_STEP_HZ)) {
+            CHECK(!"half period out of range");
+        }
+        if (fabsf(target - rate) > max_lag) {
+            max_lag = fabsf(target - rate);
+        }
+        tick_sum += ticks;
+        stepping_hz = now_hz;
+    }
+    int64_t elapsed = host_time_ns() - start;
+
+    // A 2 s period reverses twice a cycle; the ramp lags, so the last
+    // reversal falls after the end
+    CHECK_EQ(reversals, SIM_SECONDS - 1);
+
+    printf("BENCH {\"bench\":\"stepper_ramp\",\"op\":\"update\",\"updates\":%d,"
+           "\"ns_per_op\":%lld,\"max_lag_hz\":%.0f,\"tick_sum\":%llu}\n",
+           updates, (long long)(elapsed / updates), max_lag, (unsigned long long)tick_sum);
+}
+
+int main(void)
+{
+    test_steps_for_deg();
+    test_move_duration();
+    test_speed_to_hz();
+    test_rate_limit();
+    test_half_period_ticks();
+    test_ramp_update();
+    bench_ramp();
+    return host_test_result("test_stepper_math");
+}
@@ -0,0 +1,246 @@
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "telemetry_codec.h"
+
+#define VECTOR_CASES   200
+#define VECTOR_SAMPLES 64
+#define BENCH_SAMPLES  1000000
+
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static size_t encode_one(float scale, const float *values, int count, uint8_t *buf, size_t cap)
+{
+    telemetry_encoder_t enc;
+    CHECK(telemetry_encoder_init(&enc, buf, cap, 1, scale));
+    for (int i = 0; i < count; i++) {
+        CHECK(telemetry_encode(&enc, &values[i]));
+    }
+    return enc.len;
+}
+
+static void test_init(void)
+{
+    uint8_t buf[8];
+    telemetry_encoder_t enc;
+    telemetry_decoder_t dec;
+    CHECK(!telemetry_encoder_init(&enc, buf, sizeof(buf), 0, 1.0f));
+    CHECK(!telemetry_encoder_init(&enc, buf, sizeof(buf), TELEMETRY_MAX_CHANNELS + 1, 1.0f));
+    CHECK(!telemetry_encoder_init(&enc, buf, sizeof(buf), 1, 0.0f));
+    CHECK(!telemetry_encoder_init(&enc, buf, sizeof(buf), 1, -1.0f));
+    CHECK(!telemetry_encoder_init(&enc, buf, sizeof(buf), 1, NAN));
+    CHECK(!telemetry_decoder_init(&dec, buf, sizeof(buf), 0, 1.0f));
+    CHECK(telemetry_encoder_init(&enc, buf, sizeof(buf), TELEMETRY_MAX_CHANNELS, 0.01f));
+}
+
+static void test_zigzag(void)
+{
+    CHECK_EQ(telemetry_zigzag(0), 0);
+    CHECK_EQ(telemetry_zigzag(-1), 1);
+    CHECK_EQ(telemetry_zigzag(1), 2);
+    CHECK_EQ(telemetry_zigzag(INT32_MAX), 0xFFFFFFFE);
+    CHECK_EQ(telemetry_zigzag(INT32_MIN), 0xFFFFFFFF);
+    for (int32_t v = -1000; v <= 1000; v++) {
+        CHECK_EQ(telemetry_unzigzag(telemetry_zigzag(v)), v);
+    }
+}
+
+// Quantisation rounds half away from zero, like roundf
+static void test_rounding(void)
+{
+    uint8_t buf[16];
+    const float values[] = { 0.5f, -0.5f, 1.49f, -2.5f };
+    CHECK_EQ(encode_one(1.0f, values, 4, buf, sizeof(buf)), 4);
+    // q = 1, -1, 1, -3: deltas 1, -2, 2, -4
+    const uint8_t expect[] = { 2, 3, 4, 7 };
+    CHECK(memcmp(buf, expect, sizeof(expect)) == 0);
+
+    // 0.25 / 0.5 is exactly 0.5 and rounds up to 1
+    const float quarter = 0.25f;
+    CHECK_EQ(encode_one(0.5f, &quarter, 1, buf, sizeof(buf)), 1);
+    CHECK_EQ(buf[0], 2);
+}
+
+// Out-of-range values saturate, NaN codes as 0
+static void test_clamp(void)
+{
+    uint8_t buf[32];
+    const float values[] = { 1e12f, -1e12f, NAN, INFINITY, -INFINITY };
+    size_t len = encode_one(1.0f, values, 5, buf, sizeof(buf));
+
+    telemetry_decoder_t dec;
+    float out;
+    CHECK(telemetry_decoder_init(&dec, buf, len, 1, 1.0f));
+    CHECK(telemetry_decode(&dec, &out));
+    CHECK(out == (float)INT32_MAX);
+    CHECK(telemetry_decode(&dec, &out));
+    CHECK(out == (float)INT32_MIN);
+    CHECK(telemetry_decode(&dec, &out));
+    CHECK(out == 0.0f);
+    CHECK(telemetry_decode(&dec, &out));
+    CHECK(out == (float)INT32_MAX);
+    CHECK(telemetry_decode(&dec, &out));
+    CHECK(out == (float)INT32_MIN);
+    CHECK(!telemetry_decode(&dec, &out));
+}
+
+// Deltas wrap in 32 bits: INT32_MAX then INT32_MIN is a delta of +1
+static void test_wrap(void)
+{
+    uint8_t buf[16];
+    const float values[] = { 1e12f, -1e12f };
+    CHECK_EQ(encode_one(1.0f, values, 2, buf, sizeof(buf)), 6);
+    CHECK_EQ(buf[5], 2);
+
+    telemetry_decoder_t dec;
+    float out[2];
+    CHECK(telemetry_decoder_init(&dec, buf, 6, 1, 1.0f));
+    CHECK(telemetry_decode(&dec, &out[0]));
+    CHECK(telemetry_decode(&dec, &out[1]));
+    CHECK(out[1] == (float)INT32_MIN);
+}
+
+static void test_full_and_truncated(void)
+{
+    uint8_t buf[4];
+    telemetry_encoder_t enc;
+    const float sample[2] = { 100.0f, -100.0f };   // two 2-byte varints
+
+    CHECK(telemetry_encoder_init(&enc, buf, sizeof(buf), 2, 1.0f));
+    CHECK(telemetry_encode(&enc, sample));
+    CHECK_EQ(enc.len, 4);
+    // A sample that does not fit leaves the batch as it was
+    const float next[2] = { 0.0f, 0.0f };
+    CHECK(!telemetry_encode(&enc, next));
+    CHECK_EQ(enc.len, 4);
+    CHECK_EQ(enc.count, 1);
+
+    telemetry_decoder_t dec;
+    float out[2];
+    CHECK(telemetry_decoder_init(&dec, buf, 3, 2, 1.0f));
+    CHECK(!telemetry_decode(&dec, out));
+
+    // A varint longer than five bytes is rejected
+    const uint8_t overlong[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 };
+    CHECK(telemetry_decoder_init(&dec, overlong, sizeof(overlong), 1, 1.0f));
+    CHECK(!telemetry_decode(&dec, out));
+}
+
+static uint32_t float_bits(float f)
+{
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// Random walks with spikes and special values, one line per case:
+//   channels scale_bits cap count data_hex sample_bits...
+// test_telemetry_codec.py feeds the same samples to telemetry_codec.py and
+// expects the same bytes.
+static void print_vectors(void)
+{
+    static const float scales[] = { 0.001f, 0.01f, 0.1f, 1.0f, 0.3f };
+    static const float specials[] = { NAN, INFINITY, -INFINITY, 3e9f, -3e9f, 0.5f, -0.5f, 1e-40f };
+    uint32_t seed = 0x9E3779B9;
+
+    for (int n = 0; n < VECTOR_CASES; n++) {
+        uint8_t channels = 1 + xorshift32(&seed) % TELEMETRY_MAX_CHANNELS;
+        float scale = scales[xorshift32(&seed) % (sizeof(scales) / sizeof(scales[0]))];
+        size_t cap = n % 4 == 0 ? 16 + xorshift32(&seed) % 64 : 512;
+
+        float samples[VECTOR_SAMPLES][TELEMETRY_MAX_CHANNELS];
+        float level[TELEMETRY_MAX_CHANNELS];
+        for (int c = 0; c < channels; c++) {
+            level[c] = (float)(int32_t)xorshift32(&seed) / 65536.0f;
+        }
+        for (int i = 0; i < VECTOR_SAMPLES; i++) {
+            for (int c = 0; c < channels; c++) {
+                uint32_t r = xorshift32(&seed);
+                if (r % 50 == 0) {
+                    samples[i][c] = specials[(r >> 8) % (sizeof(specials) / sizeof(specials[0]))];
+                } else {
+                    level[c] += ((int32_t)(r >> 8) % 2001 - 1000) * scale / 100.0f;
+                    samples[i][c] = level[c];
+                }
+            }
+        }
+
+        uint8_t buf[512];
+        telemetry_encoder_t enc;
+        telemetry_encoder_init(&enc, buf, cap, channels, scale);
+        for (int i = 0; i < VECTOR_SAMPLES && telemetry_encode(&enc, samples[i]); i++) {
+        }
+
+        printf("%u %08x %zu %u ", channels, float_bits(scale), cap, enc.count);
+        for (size_t i = 0; i < enc.len; i++) {
+            printf("%02x", buf[i]);
+        }
+        if (enc.len == 0) {
+            printf("-");
+        }
+        for (int i = 0; i < VECTOR_SAMPLES; i++) {
+            for (int c = 0; c < channels; c++) {
+                printf(" %08x", float_bits(samples[i][c]));
+            }
+        }
+        printf("\n");
+    }
+}
+
+static void bench_codec(void)
+{
+    static uint8_t buf[BENCH_SAMPLES * 2 * 2];
+    static float out[BENCH_SAMPLES][2];
+    uint32_t seed = 0x2545F491;
+    telemetry_encoder_t enc;
+    telemetry_encoder_init(&enc, buf, sizeof(buf), 2, 0.01f);
+
+    int64_t start = host_time_ns();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        float noise = (xorshift32(&seed) % 1000) / 1000.0f - 0.5f;
+        float sample[2] = {
+            21.5f + 2.0f * sinf(i * 0.01f) + 0.05f * noise,
+            48.0f + 5.0f * sinf(i * 0.003f) + 0.1f * noise,
+        };
+        CHECK(telemetry_encode(&enc, sample));
+    }
+    int64_t encoded = host_time_ns();
+
+    telemetry_decoder_t dec;
+    telemetry_decoder_init(&dec, buf, enc.len, 2, 0.01f);
+    int decoded = 0;
+    while (decoded < BENCH_SAMPLES && telemetry_decode(&dec, out[decoded])) {
+        decoded++;
+    }
+    int64_t end = host_time_ns();
+    CHECK_EQ(decoded, BENCH_SAMPLES);
+
+    printf("BENCH {\"bench\":\"telemetry\",\"op\":\"codec\",\"samples\":%d,\"bytes_per_sample\":%.2f,"
+           "\"encode_ns_per_sample\":%lld,\"decode_ns_per_sample\":%lld}\n",
+           BENCH_SAMPLES, (double)enc.len / BENCH_SAMPLES,
+           (long long)((encoded - start) / BENCH_SAMPLES), (long long)((end - encoded) / BENCH_SAMPLES));
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--vectors") == 0) {
+        print_vectors();
+        return 0;
+    }
+
+    test_init();
+    test_zigzag();
+    test_rounding();
+    test_clamp();
+    test_wrap();
+    test_full_and_truncated();
+    bench_codec();
+    return host_test_result("test_telemetry_codec");
+}
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Check that comm_espidf/Client/telemetry_codec.py packs samples into the same
+bytes as components/telemetry, and decodes them to the same values.
+
+Usage: python test_telemetry_codec.py <test_telemetry_codec binary>
+
+The C test prints its vectors with --vectors; see print_vectors() there.
+"""
+
+import math
+import os
+import struct
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'comm_espidf', 'Client'))
+import telemetry_codec
+
+def from_bits(word):
+    return struct.unpack('<f', struct.pack('<I', int(word, 16)))[0]
+
+def same_float(a, b):
+    return (math.isnan(a) and math.isnan(b)) or a == b
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__.strip())
+        sys.exit(2)
+
+    lines = subprocess.run([sys.argv[1], '--vectors'], check=True, capture_output=True,
+                           text=True).stdout.splitlines()
+    failures = 0
+    for n, line in enumerate(lines):
+        fields = line.split()
+        channels, scale, cap, count = int(fields[0]), from_bits(fields[1]), int(fields[2]), int(fields[3])
+        data = b'' if fields[4] == '-' else bytes.fromhex(fields[4])
+        values = [from_bits(w) for w in fields[5:]]
+        samples = [values[i:i + channels] for i in range(0, len(values), channels)]
+
+        py_data, py_count = telemetry_codec.encode(samples, scale, max_len=cap)
+        if py_data != data or py_count != count:
+            print(f"case {n}: encode differs: C {count} samples {data.hex()}, "
+                  f"Python {py_count} samples {py_data.hex()}")
+            failures += 1
+            continue
+
+        # Decoding must give back the quantised values, NaN coded as 0
+        inv_scale = telemetry_codec.f32(1.0 / scale)
+        for i, sample in enumerate(telemetry_codec.decode(data, channels, scale)):
+            expect = [telemetry_codec.f32(telemetry_codec.f32(telemetry_codec.quantise(v, inv_scale)) * scale)
+                      for v in samples[i]]
+            if not all(same_float(a, b) for a, b in zip(sample, expect)):
+                print(f"case {n}: sample {i} decodes to {sample}, expected {expect}")
+                failures += 1
+                break
+
+    if failures or not lines:
+        print(f"test_telemetry_codec.py: {failures} of {len(lines)} cases failed")
+        sys.exit(1)
+    print(f"test_telemetry_codec.py: {len(lines)} cases ok")
+
+if __name__ == "__main__":
+    main()
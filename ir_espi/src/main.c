@@ -1,20 +1,179 @@
 #include <stdio.h>
+#include <inttypes.h>
+#include <stdbool.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
 #include "esp_log.h"
+#include "ir_sensor.h"
 
-#define PROXIMITY_SENSOR_PIN GPIO_NUM_4
 #define TAG "PROXIMITY_SENSOR"
 
+// Sleep in automatic light sleep until the sensor output changes instead of polling it
+#ifndef LOW_POWER_MONITOR
+#define LOW_POWER_MONITOR 1
+#endif
+
+#define STATS_INTERVAL_MS 60000
+
+// Output that follows the sensor level once the monitor task has handled an
+// edge, -1 for none. A scope on the sensor output and this pin shows the
+// whole edge-to-handler latency, including the chip's wakeup before the
+// sleep exit hook runs, which no on-chip timestamp can see.
+#ifndef LATENCY_PROBE_GPIO
+#define LATENCY_PROBE_GPIO -1
+#endif
+
+#if LOW_POWER_MONITOR
+typedef struct {
+    uint32_t count;
+    int64_t sum_us;
+    int64_t min_us;
+    int64_t max_us;
+} latency_t;
+
+static TaskHandle_t monitor_task;
+static volatile int64_t sleep_exit_us;   // last GPIO wakeup from light sleep, 0 once an edge took it
+static volatile int64_t edge_start_us;
+static volatile bool edge_from_sleep;
+static volatile uint32_t wake_count;
+
+// Edges that woke the chip count from the light sleep exit hook, edges that
+// arrived while it was awake from the ISR; both end with the monitor task
+// running
+static latency_t sleep_latency = { .min_us = INT64_MAX };
+static latency_t awake_latency = { .min_us = INT64_MAX };
+
+static void latency_add(latency_t *lat, int64_t us)
+{
+    lat->count++;
+    lat->sum_us += us;
+    if (us < lat->min_us) lat->min_us = us;
+    if (us > lat->max_us) lat->max_us = us;
+}
+
+static void latency_log(const char *name, const latency_t *lat)
+{
+    if (lat->count > 0) {
+        ESP_LOGI(TAG, "%s: %" PRIu32 " edges, min %" PRId64 " us, avg %" PRId64 " us, max %" PRId64 " us",
+                 name, lat->count, lat->min_us, lat->sum_us / lat->count, lat->max_us);
+    }
+}
+
+// Runs in the idle task as automatic light sleep returns, before the GPIO
+// interrupt that woke the chip is serviced
+static esp_err_t sleep_exit_cb(int64_t sleep_time_us, void *arg)
+{
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+        sleep_exit_us = esp_timer_get_time();
+    }
+    return ESP_OK;
+}
+
+static void IRAM_ATTR proximity_isr(void *arg)
+{
+    int64_t now_us = esp_timer_get_time();
+    edge_from_sleep = sleep_exit_us != 0;
+    edge_start_us = edge_from_sleep ? sleep_exit_us : now_us;
+    sleep_exit_us = 0;
+    wake_count++;
+
+    // The pin uses a level interrupt, so mask it until the task re-arms the opposite level
+    gpio_intr_disable(IR_SENSOR_PIN);
+
+    BaseType_t higher_priority_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(monitor_task, &higher_priority_woken);
+    if (higher_priority_woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+// Wake from light sleep, and interrupt, on the level opposite to the current one
+static void arm_wakeup(int level)
+{
+    gpio_wakeup_enable(IR_SENSOR_PIN, level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_intr_enable(IR_SENSOR_PIN);
+}
+
+static void report_level(int level)
+{
+    if (level == 0) {
+        ESP_LOGI(TAG, "Object detected!");
+    } else {
+        ESP_LOGI(TAG, "No object detected");
+    }
+}
+
+static void log_sleep_stats(void)
+{
+    ESP_LOGI(TAG, "Edges: %" PRIu32 ", handled: %" PRIu32, wake_count,
+             sleep_latency.count + awake_latency.count);
+    latency_log("Sleep-exit-to-handler latency", &sleep_latency);
+    latency_log("ISR-to-handler latency (awake)", &awake_latency);
+
+    // Time spent per power mode, including light sleep residency (needs CONFIG_PM_PROFILING)
+    esp_pm_dump_locks(stdout);
+}
+
 void app_main(void)
 {
-    gpio_set_direction(PROXIMITY_SENSOR_PIN, GPIO_MODE_INPUT);
+    ESP_ERROR_CHECK(ir_sensor_init(GPIO_INTR_DISABLE));
+
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = 160,
+        .min_freq_mhz = 40,
+        .light_sleep_enable = true,
+    };
+    ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
+    ESP_ERROR_CHECK(esp_sleep_enable_gpio_wakeup());
+
+    static esp_pm_sleep_cbs_register_config_t sleep_cbs = {
+        .exit_cb = sleep_exit_cb,
+    };
+    ESP_ERROR_CHECK(esp_pm_light_sleep_register_cbs(&sleep_cbs));
+
+#if LATENCY_PROBE_GPIO >= 0
+    gpio_config_t probe_conf = {
+        .pin_bit_mask = 1ULL << LATENCY_PROBE_GPIO,
+        .mode = GPIO_MODE_OUTPUT,
+    };
+    ESP_ERROR_CHECK(gpio_config(&probe_conf));
+#endif
+
+    monitor_task = xTaskGetCurrentTaskHandle();
+    ESP_ERROR_CHECK(ir_sensor_add_isr(proximity_isr, NULL));
+
+    int level = gpio_get_level(IR_SENSOR_PIN);
+    report_level(level);
+    arm_wakeup(level);
 
     while (1) {
-        int sensor_value = gpio_get_level(PROXIMITY_SENSOR_PIN);
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STATS_INTERVAL_MS)) == 0) {
+            log_sleep_stats();
+            continue;
+        }
+
+        int64_t latency_us = esp_timer_get_time() - edge_start_us;
+        level = gpio_get_level(IR_SENSOR_PIN);
+#if LATENCY_PROBE_GPIO >= 0
+        gpio_set_level(LATENCY_PROBE_GPIO, level);
+#endif
+        latency_add(edge_from_sleep ? &sleep_latency : &awake_latency, latency_us);
 
-        if (sensor_value == 0) {
+        report_level(level);
+        arm_wakeup(level);
+    }
+}
+#else
+void app_main(void)
+{
+    ir_sensor_init(GPIO_INTR_DISABLE);
+
+    while (1) {
+        if (ir_sensor_object_detected()) {
             ESP_LOGI(TAG, "Object detected!");
         } else {
             ESP_LOGI(TAG, "No object detected");
@@ -22,3 +181,4 @@ void app_main(void)
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
+#endif
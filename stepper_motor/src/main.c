@@ -1,45 +1,22 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "driver/gpio.h"
-#include "esp_timer.h"  // For esp_timer_get_time()
+#include "stepper.h"
 
-#define STEP_PIN GPIO_NUM_14
-#define DIR_PIN  GPIO_NUM_12
-#define EN_PIN   GPIO_NUM_13
-
-#define MICROSTEPS_PER_REV 6400
-#define STEPS_FOR_60_DEG ((MICROSTEPS_PER_REV * 60) / 360) // 1067 steps
-
-void delay_us(uint32_t us) {
-    int64_t start = esp_timer_get_time();
-    while ((esp_timer_get_time() - start) < us);
-}
+#define STEPS_FOR_60_DEG STEPPER_STEPS_FOR(60) // 1066 steps at 6400 per rev
 
 void app_main(void)
 {
-    gpio_config_t io_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = (1ULL << STEP_PIN) | (1ULL << DIR_PIN) | (1ULL << EN_PIN),
-        .pull_down_en = 0,
-        .pull_up_en = 0
-    };
-    gpio_config(&io_conf);
+    stepper_init();
 
-    gpio_set_level(EN_PIN, 0);  // Enable
+    stepper_enable(true);
     vTaskDelay(pdMS_TO_TICKS(100));
 
-    gpio_set_level(DIR_PIN, 1);  // Direction
+    stepper_set_direction(true);
 
-    for (int i = 0; i < STEPS_FOR_60_DEG; i++) {
-        gpio_set_level(STEP_PIN, 1);
-        delay_us(500);
-        gpio_set_level(STEP_PIN, 0);
-        delay_us(500);
-    }
+    stepper_step_blocking(STEPS_FOR_60_DEG, 500);
 
-    gpio_set_level(EN_PIN, 1);  // Disable
+    stepper_enable(false);
 
     while (1) {
         vTaskDelay(portMAX_DELAY);